@@ -0,0 +1,274 @@
+/*********************                                                        */
+/*! \file AcasNetworkEncoding.h
+ ** \verbatim
+ ** Top contributors (to current version):
+ **   Guy Katz
+ ** This file is part of the Reluplex project.
+ ** Copyright (c) 2016-2017 by the authors listed in the file AUTHORS
+ ** (in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved. See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **/
+
+#ifndef __AcasNetworkEncoding_h__
+#define __AcasNetworkEncoding_h__
+
+#include "AcasNeuralNetwork.h"
+#include "InputDomainSplitter.h"
+#include "MString.h"
+#include "Map.h"
+#include "Reluplex.h"
+#include "SymbolicBoundTightener.h"
+#include "Vector.h"
+
+#include <functional>
+
+/*
+  Helpers shared by the property drivers, which all encode an ACAS Xu network into Reluplex
+  the same way. Neuron j of layer i is Index(i, j, false) for its b variable and
+  Index(i, j, true) for its f variable; the inputs are f variables of layer 0.
+*/
+
+struct Index
+{
+    Index( unsigned newRow, unsigned newCol, unsigned newF )
+        : row( newRow ), col( newCol ), f( newF )
+    {
+    }
+
+    unsigned row;
+    unsigned col;
+    bool f;
+
+    bool operator<( const Index &other ) const
+    {
+        if ( row != other.row )
+            return row < other.row;
+        if ( col != other.col )
+            return col < other.col;
+
+        if ( !f && other.f )
+            return true;
+        if ( f && !other.f )
+            return false;
+
+        return false;
+    }
+};
+
+// Bound every neuron by interval arithmetic over the current input bounds. Bounds that are
+// already tighter (e.g., from the property) are kept.
+void setIntervalBounds( Reluplex &reluplex, AcasNeuralNetwork &neuralNetwork,
+                        const Map<Index, unsigned> &nodeToVars, unsigned numLayersInUse )
+{
+    Vector<double> inputLowerBounds;
+    Vector<double> inputUpperBounds;
+    for ( unsigned i = 0; i < neuralNetwork.getLayerSize( 0 ); ++i )
+    {
+        inputLowerBounds.append( reluplex.getLowerBound( nodeToVars[Index(0, i, true)] ) );
+        inputUpperBounds.append( reluplex.getUpperBound( nodeToVars[Index(0, i, true)] ) );
+    }
+
+    Vector<Vector<double> > lowerBounds;
+    Vector<Vector<double> > upperBounds;
+    neuralNetwork.computeIntervalBounds( inputLowerBounds, inputUpperBounds, lowerBounds, upperBounds );
+
+    const VariableBound *currentLowerBounds = reluplex.getLowerBounds();
+    const VariableBound *currentUpperBounds = reluplex.getUpperBounds();
+
+    for ( unsigned layer = 1; layer < numLayersInUse; ++layer )
+    {
+        for ( unsigned j = 0; j < neuralNetwork.getLayerSize( layer ); ++j )
+        {
+            unsigned b = nodeToVars[Index(layer, j, false)];
+            double lower = lowerBounds[layer][j];
+            double upper = upperBounds[layer][j];
+
+            if ( !currentLowerBounds[b].finite() || lower > currentLowerBounds[b].getBound() )
+                reluplex.setLowerBound( b, lower );
+            if ( !currentUpperBounds[b].finite() || upper < currentUpperBounds[b].getBound() )
+                reluplex.setUpperBound( b, upper );
+
+            // The output layer has no ReLUs
+            if ( layer + 1 == numLayersInUse )
+                continue;
+
+            unsigned f = nodeToVars[Index(layer, j, true)];
+            if ( lower > currentLowerBounds[f].getBound() )
+                reluplex.setLowerBound( f, lower );
+            if ( !currentUpperBounds[f].finite() || upper < currentUpperBounds[f].getBound() )
+                reluplex.setUpperBound( f, upper > 0.0 ? upper : 0.0 );
+        }
+    }
+}
+
+/*
+  A symbolic bound tightener that describes the network (see SymbolicBoundTightener.h). Like
+  the Reluplex it is passed to, it must outlive the solving.
+*/
+class AcasSymbolicBoundTightener : public SymbolicBoundTightener
+{
+public:
+    AcasSymbolicBoundTightener( AcasNeuralNetwork &neuralNetwork, const Map<Index, unsigned> &nodeToVars,
+                                unsigned numLayersInUse )
+        : SymbolicBoundTightener( layerSizes( neuralNetwork, numLayersInUse ) )
+    {
+        for ( unsigned i = 0; i < neuralNetwork.getLayerSize( 0 ); ++i )
+            setInputVariable( i, nodeToVars[Index(0, i, true)] );
+
+        for ( unsigned layer = 1; layer < numLayersInUse; ++layer )
+        {
+            bool outputLayer = ( layer + 1 == numLayersInUse );
+
+            for ( unsigned target = 0; target < neuralNetwork.getLayerSize( layer ); ++target )
+            {
+                unsigned b = nodeToVars[Index(layer, target, false)];
+                unsigned f = outputLayer ? b : nodeToVars[Index(layer, target, true)];
+                setNeuronVariables( layer, target, b, f );
+                setBias( layer, target, neuralNetwork.getBias( layer, target ) );
+
+                for ( unsigned source = 0; source < neuralNetwork.getLayerSize( layer - 1 ); ++source )
+                    setWeight( layer - 1, source, target, neuralNetwork.getWeight( layer - 1, source, target ) );
+            }
+        }
+    }
+
+private:
+    static Vector<unsigned> layerSizes( AcasNeuralNetwork &neuralNetwork, unsigned numLayersInUse )
+    {
+        Vector<unsigned> sizes;
+        for ( unsigned i = 0; i < numLayersInUse; ++i )
+            sizes.append( neuralNetwork.getLayerSize( i ) );
+        return sizes;
+    }
+};
+
+// The query restricted to one input box, for solving by input splitting
+class AcasBoxQuery : public InputDomainSplitter::Query
+{
+public:
+    AcasBoxQuery( unsigned numVariables, const String &name, AcasNeuralNetwork &neuralNetwork,
+                  const Map<Index, unsigned> &nodeToVars, unsigned numLayersInUse )
+        : _reluplex( numVariables, NULL, name )
+        , _symbolicBoundTightener( neuralNetwork, nodeToVars, numLayersInUse )
+    {
+    }
+
+    Reluplex &getReluplex()
+    {
+        return _reluplex;
+    }
+
+    Reluplex _reluplex;
+    AcasSymbolicBoundTightener _symbolicBoundTightener;
+};
+
+// The splitter that solveByInputSplitting() is running, if any, so that a signal can stop it
+InputDomainSplitter *runningInputDomainSplitter = NULL;
+
+void quitInputSplitting()
+{
+    if ( runningInputDomainSplitter )
+        runningInputDomainSplitter->quit();
+}
+
+/*
+  Split the input region into boxes, and solve them in parallel (see InputDomainSplitter.h).
+  encodeQuery encodes the network and the property into a fresh Reluplex, whose input bounds
+  are then narrowed to the box; printSolution prints the assignment of a satisfying one.
+*/
+void solveByInputSplitting( AcasNeuralNetwork &neuralNetwork, const String &networkPath, char *finalOutputFile,
+                            const Map<Index, unsigned> &nodeToVars, unsigned numVariables, unsigned numLayersInUse,
+                            std::function<void( Reluplex & )> encodeQuery,
+                            std::function<void( Reluplex & )> printSolution )
+{
+    unsigned inputLayerSize = neuralNetwork.getLayerSize( 0 );
+
+    // An empty box keeps the input bounds of the property
+    InputDomainSplitter::QueryFactory createQuery = [&]( const InputBox &box ) -> InputDomainSplitter::Query *
+        {
+            AcasBoxQuery *query = new AcasBoxQuery( numVariables, networkPath, neuralNetwork, nodeToVars, numLayersInUse );
+            Reluplex &reluplex( query->_reluplex );
+
+            encodeQuery( reluplex );
+            for ( unsigned i = 0; i < box._lowerBounds.size(); ++i )
+            {
+                reluplex.setLowerBound( nodeToVars[Index(0, i, true)], box._lowerBounds.get( i ) );
+                reluplex.setUpperBound( nodeToVars[Index(0, i, true)], box._upperBounds.get( i ) );
+            }
+
+            reluplex.setSymbolicBoundTightener( &query->_symbolicBoundTightener );
+
+            reluplex.setLogging( false );
+            reluplex.setDumpStates( false );
+            reluplex.togglePrintStatistics( false );
+            reluplex.toggleAlmostBrokenReluEliminiation( false );
+
+            setIntervalBounds( reluplex, neuralNetwork, nodeToVars, numLayersInUse );
+            return query;
+        };
+
+    InputBox box;
+    InputDomainSplitter::Query *query = createQuery( box );
+    for ( unsigned i = 0; i < inputLayerSize; ++i )
+    {
+        box._lowerBounds.append( query->getReluplex().getLowerBound( nodeToVars[Index(0, i, true)] ) );
+        box._upperBounds.append( query->getReluplex().getUpperBound( nodeToVars[Index(0, i, true)] ) );
+    }
+    delete query;
+
+    Vector<double> sensitivity;
+    neuralNetwork.computeInputSensitivity( sensitivity );
+
+    try
+    {
+        InputDomainSplitter inputDomainSplitter( createQuery, sensitivity );
+        runningInputDomainSplitter = &inputDomainSplitter;
+
+        Reluplex::FinalStatus result = inputDomainSplitter.solve( box );
+        inputDomainSplitter.printStatistics();
+
+        if ( result == Reluplex::SAT )
+        {
+            printSolution( *inputDomainSplitter.getSatisfyingReluplex() );
+        }
+        else if ( result == Reluplex::UNSAT )
+        {
+            printf( "Can't solve!\n" );
+        }
+        else if ( result == Reluplex::ERROR )
+        {
+            printf( "Reluplex error!\n" );
+        }
+        else
+        {
+            printf( "Reluplex not done (quit called?)\n" );
+        }
+
+        printf( "Number of explored states: %llu\n", inputDomainSplitter.numStatesExplored() );
+
+        if ( finalOutputFile )
+            inputDomainSplitter.printFinalStatistics( finalOutputFile, networkPath );
+
+        runningInputDomainSplitter = NULL;
+    }
+    catch ( const Error &e )
+    {
+        runningInputDomainSplitter = NULL;
+        printf( "main.cpp: Error caught. Code: %u. Errno: %i. Message: %s\n",
+                e.code(),
+                e.getErrno(),
+                e.userMessage() );
+        fflush( 0 );
+    }
+}
+
+#endif // __AcasNetworkEncoding_h__
+
+//
+// Local Variables:
+// compile-command: "make -C .. "
+// tags-file-name: "../TAGS"
+// c-basic-offset: 4
+// End:
+//
@@ -13,6 +13,7 @@
 #include <cstdio>
 #include <signal.h>
 
+#include "AcasNetworkEncoding.h"
 #include "AcasNeuralNetwork.h"
 #include "File.h"
 #include "Reluplex.h"
@@ -20,33 +21,6 @@
 
 const char *FULL_NET_PATH = "./nnet/ACASXU_run2a_1_1_batch_2000.nnet";
 
-struct Index
-{
-    Index( unsigned newRow, unsigned newCol, unsigned newF )
-        : row( newRow ), col( newCol ), f( newF )
-    {
-    }
-
-    unsigned row;
-    unsigned col;
-    bool f;
-
-    bool operator<( const Index &other ) const
-    {
-        if ( row != other.row )
-            return row < other.row;
-        if ( col != other.col )
-            return col < other.col;
-
-        if ( !f && other.f )
-            return true;
-        if ( f && !other.f )
-            return false;
-
-        return false;
-    }
-};
-
 double normalizeInput( unsigned inputIndex, double value, AcasNeuralNetwork &neuralNetwork )
 {
     double min = neuralNetwork._network->mins[inputIndex];
@@ -346,6 +320,10 @@ bool advMain( int argc, char **argv, unsigned inputPoint, double inputDelta, uns
     reluplex.initializeCell( outputSlackVar, minimalVar, 1 );
     reluplex.initializeCell( outputSlackVar, runnerUpVar, -1 );
 
+    // The network, for symbolic and LP bound tightening (both off by default, see Reluplex.h)
+    AcasSymbolicBoundTightener symbolicBoundTightener( neuralNetwork, nodeToVars, numLayersInUse );
+    reluplex.setSymbolicBoundTightener( &symbolicBoundTightener );
+
     reluplex.setLogging( false );
     reluplex.setDumpStates( false );
     reluplex.toggleAlmostBrokenReluEliminiation( false );
@@ -362,6 +340,8 @@ bool advMain( int argc, char **argv, unsigned inputPoint, double inputDelta, uns
 
         double totalError = 0.0;
 
+        setIntervalBounds( reluplex, neuralNetwork, nodeToVars, numLayersInUse );
+
         Reluplex::FinalStatus result = reluplex.solve();
         if ( result == Reluplex::SAT )
         {
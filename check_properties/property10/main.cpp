@@ -13,6 +13,7 @@
 #include <cstdio>
 #include <signal.h>
 
+#include "AcasNetworkEncoding.h"
 #include "AcasNeuralNetwork.h"
 #include "File.h"
 #include "Reluplex.h"
@@ -20,33 +21,6 @@
 
 const char *FULL_NET_PATH = "./nnet/ACASXU_run2a_4_5_batch_2000.nnet";
 
-struct Index
-{
-    Index( unsigned newRow, unsigned newCol, unsigned newF )
-        : row( newRow ), col( newCol ), f( newF )
-    {
-    }
-
-    unsigned row;
-    unsigned col;
-    bool f;
-
-    bool operator<( const Index &other ) const
-    {
-        if ( row != other.row )
-            return row < other.row;
-        if ( col != other.col )
-            return col < other.col;
-
-        if ( !f && other.f )
-            return true;
-        if ( f && !other.f )
-            return false;
-
-        return false;
-    }
-};
-
 double normalizeInput( unsigned inputIndex, double value, AcasNeuralNetwork &neuralNetwork )
 {
     double min = neuralNetwork._network->mins[inputIndex];
@@ -308,6 +282,10 @@ int main( int argc, char **argv )
     reluplex.initializeCell( outputConstraintVariable, targetOutputVariable, 1.0 );
     reluplex.initializeCell( outputConstraintVariable, otherOutputVariable, -1.0 );
 
+    // The network, for symbolic and LP bound tightening (both off by default, see Reluplex.h)
+    AcasSymbolicBoundTightener symbolicBoundTightener( neuralNetwork, nodeToVars, numLayersInUse );
+    reluplex.setSymbolicBoundTightener( &symbolicBoundTightener );
+
     reluplex.setLogging( false );
     reluplex.setDumpStates( false );
     reluplex.toggleAlmostBrokenReluEliminiation( false );
@@ -365,6 +343,7 @@ int main( int argc, char **argv )
         }
         printf( "\n\n" );
 
+        setIntervalBounds( reluplex, neuralNetwork, nodeToVars, numLayersInUse );
         reluplex.initialize();
 
         printf( "\nAfter reluplex initialization, output ranges are:\n" );
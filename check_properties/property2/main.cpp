@@ -13,38 +13,12 @@
 #include <cstdio>
 #include <signal.h>
 
+#include "AcasNetworkEncoding.h"
 #include "AcasNeuralNetwork.h"
 #include "File.h"
 #include "Reluplex.h"
 #include "MString.h"
 
-struct Index
-{
-    Index( unsigned newRow, unsigned newCol, unsigned newF )
-        : row( newRow ), col( newCol ), f( newF )
-    {
-    }
-
-    unsigned row;
-    unsigned col;
-    bool f;
-
-    bool operator<( const Index &other ) const
-    {
-        if ( row != other.row )
-            return row < other.row;
-        if ( col != other.col )
-            return col < other.col;
-
-        if ( !f && other.f )
-            return true;
-        if ( f && !other.f )
-            return false;
-
-        return false;
-    }
-};
-
 double normalizeInput( unsigned inputIndex, double value, AcasNeuralNetwork &neuralNetwork )
 {
     double min = neuralNetwork._network->mins[inputIndex];
@@ -317,6 +291,10 @@ int main( int argc, char **argv )
         reluplex.initializeCell( it.second, currentVar, -1.0 );
     }
 
+    // The network, for symbolic and LP bound tightening (both off by default, see Reluplex.h)
+    AcasSymbolicBoundTightener symbolicBoundTightener( neuralNetwork, nodeToVars, numLayersInUse );
+    reluplex.setSymbolicBoundTightener( &symbolicBoundTightener );
+
     reluplex.setLogging( false );
     reluplex.setDumpStates( false );
     reluplex.toggleAlmostBrokenReluEliminiation( false );
@@ -356,6 +334,7 @@ int main( int argc, char **argv )
         }
         printf( "\n\n" );
 
+        setIntervalBounds( reluplex, neuralNetwork, nodeToVars, numLayersInUse );
         reluplex.initialize();
 
         printf( "\nAfter reluplex initialization, output ranges are:\n" );
@@ -13,38 +13,13 @@
 #include <cstdio>
 #include <signal.h>
 
+#include "AcasNetworkEncoding.h"
 #include "AcasNeuralNetwork.h"
 #include "File.h"
+#include "InputDomainSplitter.h"
 #include "Reluplex.h"
 #include "MString.h"
 
-struct Index
-{
-    Index( unsigned newRow, unsigned newCol, unsigned newF )
-        : row( newRow ), col( newCol ), f( newF )
-    {
-    }
-
-    unsigned row;
-    unsigned col;
-    bool f;
-
-    bool operator<( const Index &other ) const
-    {
-        if ( row != other.row )
-            return row < other.row;
-        if ( col != other.col )
-            return col < other.col;
-
-        if ( !f && other.f )
-            return true;
-        if ( f && !other.f )
-            return false;
-
-        return false;
-    }
-};
-
 double normalizeInput( unsigned inputIndex, double value, AcasNeuralNetwork &neuralNetwork )
 {
     double min = neuralNetwork._network->mins[inputIndex];
@@ -86,6 +61,223 @@ double normalizeOutput( double output, AcasNeuralNetwork &neuralNetwork )
     return ( output * range ) + mean;
 }
 
+// The input region of the property, normalized
+void normalizedInputBounds( unsigned input, AcasNeuralNetwork &neuralNetwork, double &min, double &max )
+{
+    max =
+        ( neuralNetwork._network->maxes[input] - neuralNetwork._network->means[input] )
+        / ( neuralNetwork._network->ranges[input] );
+    min =
+        ( neuralNetwork._network->mins[input] - neuralNetwork._network->means[input] )
+        / ( neuralNetwork._network->ranges[input] );
+}
+
+void printInputBounds( AcasNeuralNetwork &neuralNetwork )
+{
+    for ( unsigned i = 0; i < neuralNetwork.getLayerSize( 0 ); ++i )
+    {
+        double min, max;
+        normalizedInputBounds( i, neuralNetwork, min, max );
+
+        printf( "Bounds for input %u: [ %.10lf, %.10lf ]. Unnoralized: [ %.10lf, %.10lf ]\n",
+                i, min, max, unnormalizeInput( i, min, neuralNetwork ), unnormalizeInput( i, max, neuralNetwork ) );
+    }
+}
+
+// Encode the network and the property in question
+void encodeQuery( Reluplex &reluplex, AcasNeuralNetwork &neuralNetwork,
+                  const Map<Index, unsigned> &nodeToVars, const Map<Index, unsigned> &nodeToAux,
+                  const Map<unsigned, unsigned> &outputVarToConstraintNode, unsigned targetOutputVariableIndex,
+                  unsigned constantVar, unsigned numLayersInUse )
+{
+    unsigned inputLayerSize = neuralNetwork.getLayerSize( 0 );
+    unsigned outputLayerSize = neuralNetwork.getLayerSize( numLayersInUse - 1 );
+
+    // Set bounds for constant var
+    reluplex.setLowerBound( constantVar, 1.0 );
+    reluplex.setUpperBound( constantVar, 1.0 );
+
+    // Set bounds for inputs
+    for ( unsigned i = 0; i < inputLayerSize ; ++i )
+    {
+        double min, max;
+        normalizedInputBounds( i, neuralNetwork, min, max );
+
+        reluplex.setLowerBound( nodeToVars[Index(0, i, true)], min );
+        reluplex.setUpperBound( nodeToVars[Index(0, i, true)], max );
+    }
+
+    // Declare relu pairs and set bounds
+    for ( unsigned i = 1; i < numLayersInUse - 1; ++i )
+    {
+        for ( unsigned j = 0; j < neuralNetwork.getLayerSize( i ); ++j )
+        {
+            unsigned b = nodeToVars[Index(i, j, false)];
+            unsigned f = nodeToVars[Index(i, j, true)];
+
+            reluplex.setReluPair( b, f );
+            reluplex.setLowerBound( f, 0.0 );
+        }
+    }
+
+    // Mark all aux variables as basic and set their bounds to zero
+    for ( const auto &it : nodeToAux )
+    {
+        reluplex.markBasic( it.second );
+        reluplex.setLowerBound( it.second, 0.0 );
+        reluplex.setUpperBound( it.second, 0.0 );
+    }
+
+    // Mark the output constraints variable as basic, too.
+    // The target output is the smallest, i.e. most recommended.
+    for ( const auto &it : outputVarToConstraintNode )
+    {
+        reluplex.markBasic( it.second );
+        reluplex.setUpperBound( it.second, 0.0 );
+    }
+
+    // Populate the table
+    for ( unsigned layer = 0; layer < numLayersInUse - 1; ++layer )
+    {
+        unsigned targetLayerSize;
+        if ( layer + 2 == numLayersInUse )
+            targetLayerSize = outputLayerSize;
+        else
+            targetLayerSize = neuralNetwork.getLayerSize( layer + 1 );
+
+        for ( unsigned target = 0; target < targetLayerSize; ++target )
+        {
+            // This aux var will bind the F's from the previous layer to the B of this node.
+            unsigned auxVar = nodeToAux[Index(layer + 1, target, false)];
+            reluplex.initializeCell( auxVar, auxVar, -1 );
+
+            unsigned bVar = nodeToVars[Index(layer + 1, target, false)];
+            reluplex.initializeCell( auxVar, bVar, -1 );
+
+            for ( unsigned source = 0; source < neuralNetwork.getLayerSize( layer ); ++source )
+            {
+                unsigned fVar = nodeToVars[Index(layer, source, true)];
+                reluplex.initializeCell
+                    ( auxVar,
+                      fVar,
+                      neuralNetwork.getWeight( layer, source, target ) );
+            }
+
+            // Add the bias via the constant var
+            reluplex.initializeCell( auxVar,
+                                     constantVar,
+                                     neuralNetwork.getBias( layer + 1, target ) );
+        }
+    }
+
+    unsigned targetOutputVariable = nodeToVars[Index(numLayersInUse - 1, targetOutputVariableIndex, false)];
+    for ( const auto &it : outputVarToConstraintNode )
+    {
+        reluplex.initializeCell( it.second, it.second, -1 );
+        // This is the constraint between it.first and targetOutputVariableIndex
+        // e.g., output[0] - output[3]
+
+        if ( it.first == targetOutputVariableIndex )
+        {
+            printf( "Error! strange output variable constraint!\n" );
+            exit( 1 );
+        }
+
+        unsigned currentVar = nodeToVars[Index(numLayersInUse - 1, it.first, false)];
+
+        reluplex.initializeCell( it.second, targetOutputVariable, 1.0 );
+        reluplex.initializeCell( it.second, currentVar, -1.0 );
+    }
+
+    //     Range min: 1500
+    //     Range max: 1800
+    reluplex.setLowerBound( nodeToVars[Index(0, 0, true)], normalizeInput( 0, 1500, neuralNetwork ) );
+    reluplex.setUpperBound( nodeToVars[Index(0, 0, true)], normalizeInput( 0, 1800, neuralNetwork ) );
+
+    //     Theta min: -0.06
+    //     Theta max: 0.06
+    reluplex.setLowerBound( nodeToVars[Index(0, 1, true)], normalizeInput( 1, -0.06, neuralNetwork ) );
+    reluplex.setUpperBound( nodeToVars[Index(0, 1, true)], normalizeInput( 1, 0.06, neuralNetwork ) );
+
+    //     Bearing min: 3.10
+    reluplex.setLowerBound( nodeToVars[Index(0, 2, true)], normalizeInput( 2, 3.10, neuralNetwork ) );
+
+    //     Speed own min: 980
+    reluplex.setLowerBound( nodeToVars[Index(0, 3, true)], normalizeInput( 3, 980, neuralNetwork ) );
+
+    //     Speed int min: 960
+    reluplex.setLowerBound( nodeToVars[Index(0, 4, true)], normalizeInput( 4, 960, neuralNetwork ) );
+}
+
+void printSolution( Reluplex &reluplex, AcasNeuralNetwork &neuralNetwork,
+                    const Map<Index, unsigned> &nodeToVars, const Map<unsigned, unsigned> &outputVarToConstraintNode,
+                    unsigned numLayersInUse )
+{
+    unsigned inputLayerSize = neuralNetwork.getLayerSize( 0 );
+    unsigned outputLayerSize = neuralNetwork.getLayerSize( numLayersInUse - 1 );
+
+    Vector<double> inputs;
+    Vector<double> outputs;
+
+    double totalError = 0.0;
+
+    printf( "Solution found!\n\n" );
+    for ( unsigned i = 0; i < inputLayerSize; ++i )
+    {
+        double assignment = reluplex.getAssignment( nodeToVars[Index(0, i, true)] );
+        printf( "input[%u] = %lf. Normalized: %lf.\n",
+                i, unnormalizeInput( i, assignment, neuralNetwork ), assignment );
+        inputs.append( assignment );
+    }
+
+    printf( "\n" );
+    for ( unsigned i = 0; i < outputLayerSize; ++i )
+    {
+        printf( "output[%u] = %.10lf. Normalized: %lf\n", i,
+                reluplex.getAssignment( nodeToVars[Index(numLayersInUse - 1, i, false)] ),
+                normalizeOutput( reluplex.getAssignment( nodeToVars[Index(numLayersInUse - 1, i, false)] ),
+                                 neuralNetwork ) );
+    }
+
+    printf( "\nOutput using nnet:\n" );
+
+    neuralNetwork.evaluate( inputs, outputs, outputLayerSize );
+    unsigned i = 0;
+    for ( const auto &output : outputs )
+    {
+        printf( "output[%u] = %.10lf. Normalized: %lf\n", i, output,
+                normalizeOutput( output, neuralNetwork ) );
+
+        totalError +=
+            FloatUtils::abs( output -
+                             reluplex.getAssignment( nodeToVars[Index(numLayersInUse - 1, i, false)] ) );
+
+        ++i;
+    }
+
+    printf( "\n" );
+    printf( "Total error: %.10lf. Average: %.10lf\n", totalError, totalError / outputLayerSize );
+    printf( "\n" );
+
+    printf( "Output slacks:\n" );
+    for ( const auto &it : outputVarToConstraintNode )
+    {
+        printf( "\tWith variable %u: %.10lf\n", it.first, reluplex.getAssignment( it.second ) );
+    }
+    printf( "\n" );
+}
+
+void printRunTime( timeval start, timeval end )
+{
+    unsigned milliPassed = Time::timePassed( start, end );
+    unsigned seconds = milliPassed / 1000;
+    unsigned minutes = seconds / 60;
+    unsigned hours = minutes / 60;
+
+    printf( "Total run time: %u milli (%02u:%02u:%02u)\n",
+            Time::timePassed( start, end ), hours, minutes - ( hours * 60 ), seconds - ( minutes * 60 ) );
+}
+
 Reluplex *lastReluplex = NULL;
 
 void got_signal( int )
@@ -96,6 +288,8 @@ void got_signal( int )
     {
         lastReluplex->quit();
     }
+
+    quitInputSplitting();
 }
 
 int main( int argc, char **argv )
@@ -147,12 +341,8 @@ int main( int argc, char **argv )
     //   3. Each output var has an instance and an auxiliary var for its equation
     //   4. (outputLayerSize - 1) variables for the output constraints
     //   5. A single variable for the constants
-    Reluplex reluplex( inputLayerSize + ( 3 * numReluNodes ) + ( 2 * outputLayerSize ) +
-                       outputConstraintVariables + 1,
-                       finalOutputFile,
-                       networkPath );
-
-    lastReluplex = &reluplex;
+    unsigned numVariables = inputLayerSize + ( 3 * numReluNodes ) + ( 2 * outputLayerSize ) +
+        outputConstraintVariables + 1;
 
     Map<Index, unsigned> nodeToVars;
     Map<Index, unsigned> nodeToAux;
@@ -213,110 +403,37 @@ int main( int argc, char **argv )
 
     unsigned constantVar = newIndex;
 
-    // Set bounds for constant var
-    reluplex.setLowerBound( constantVar, 1.0 );
-    reluplex.setUpperBound( constantVar, 1.0 );
-
-    // Set bounds for inputs
-    for ( unsigned i = 0; i < inputLayerSize ; ++i )
-    {
-        double max =
-            ( neuralNetwork._network->maxes[i] - neuralNetwork._network->means[i] )
-            / ( neuralNetwork._network->ranges[i] );
-        double min =
-            ( neuralNetwork._network->mins[i] - neuralNetwork._network->means[i] )
-            / ( neuralNetwork._network->ranges[i] );
-
-        printf( "Bounds for input %u: [ %.10lf, %.10lf ]. Unnoralized: [ %.10lf, %.10lf ]\n",
-                i, min, max, unnormalizeInput( i, min, neuralNetwork ), unnormalizeInput( i, max, neuralNetwork ) );
-
-        reluplex.setLowerBound( nodeToVars[Index(0, i, true)], min );
-        reluplex.setUpperBound( nodeToVars[Index(0, i, true)], max );
-    }
-
-    // Declare relu pairs and set bounds
-    for ( unsigned i = 1; i < numLayersInUse - 1; ++i )
-    {
-        for ( unsigned j = 0; j < neuralNetwork.getLayerSize( i ); ++j )
-        {
-            unsigned b = nodeToVars[Index(i, j, false)];
-            unsigned f = nodeToVars[Index(i, j, true)];
-
-            reluplex.setReluPair( b, f );
-            reluplex.setLowerBound( f, 0.0 );
-        }
-    }
-
     printf( "Number of auxiliary variables: %u\n", nodeToAux.size() );
 
-    // Mark all aux variables as basic and set their bounds to zero
-    for ( const auto &it : nodeToAux )
-    {
-        reluplex.markBasic( it.second );
-        reluplex.setLowerBound( it.second, 0.0 );
-        reluplex.setUpperBound( it.second, 0.0 );
-    }
+    printInputBounds( neuralNetwork );
 
-    // Mark the output constraints variable as basic, too.
-    // The target output is the smallest, i.e. most recommended.
-    for ( const auto &it : outputVarToConstraintNode )
+    if ( DEFAULT_INPUT_SPLITTING_THREADS > 0 )
     {
-        reluplex.markBasic( it.second );
-        reluplex.setUpperBound( it.second, 0.0 );
+        timeval start = Time::sampleMicro();
+        solveByInputSplitting( neuralNetwork, networkPath, finalOutputFile, nodeToVars, numVariables, numLayersInUse,
+                               [&]( Reluplex &reluplex )
+                               {
+                                   encodeQuery( reluplex, neuralNetwork, nodeToVars, nodeToAux, outputVarToConstraintNode,
+                                                targetOutputVariableIndex, constantVar, numLayersInUse );
+                               },
+                               [&]( Reluplex &reluplex )
+                               {
+                                   printSolution( reluplex, neuralNetwork, nodeToVars, outputVarToConstraintNode, numLayersInUse );
+                               } );
+        printRunTime( start, Time::sampleMicro() );
+        return 0;
     }
 
-    // Populate the table
-    for ( unsigned layer = 0; layer < numLayersInUse - 1; ++layer )
-    {
-        unsigned targetLayerSize;
-        if ( layer + 2 == numLayersInUse )
-            targetLayerSize = outputLayerSize;
-        else
-            targetLayerSize = neuralNetwork.getLayerSize( layer + 1 );
+    Reluplex reluplex( numVariables, finalOutputFile, networkPath );
 
-        for ( unsigned target = 0; target < targetLayerSize; ++target )
-        {
-            // This aux var will bind the F's from the previous layer to the B of this node.
-            unsigned auxVar = nodeToAux[Index(layer + 1, target, false)];
-            reluplex.initializeCell( auxVar, auxVar, -1 );
-
-            unsigned bVar = nodeToVars[Index(layer + 1, target, false)];
-            reluplex.initializeCell( auxVar, bVar, -1 );
-
-            for ( unsigned source = 0; source < neuralNetwork.getLayerSize( layer ); ++source )
-            {
-                unsigned fVar = nodeToVars[Index(layer, source, true)];
-                reluplex.initializeCell
-                    ( auxVar,
-                      fVar,
-                      neuralNetwork.getWeight( layer, source, target ) );
-            }
-
-            // Add the bias via the constant var
-            reluplex.initializeCell( auxVar,
-                                     constantVar,
-                                     neuralNetwork.getBias( layer + 1, target ) );
-        }
-    }
-
-    unsigned targetOutputVariable = nodeToVars[Index(numLayersInUse - 1, targetOutputVariableIndex, false)];
-    for ( const auto &it : outputVarToConstraintNode )
-    {
-        reluplex.initializeCell( it.second, it.second, -1 );
-        // This is the constraint between it.first and targetOutputVariableIndex
-        // e.g., output[0] - output[3]
-
-        if ( it.first == targetOutputVariableIndex )
-        {
-            printf( "Error! strange output variable constraint!\n" );
-            exit( 1 );
-        }
+    lastReluplex = &reluplex;
 
-        unsigned currentVar = nodeToVars[Index(numLayersInUse - 1, it.first, false)];
+    encodeQuery( reluplex, neuralNetwork, nodeToVars, nodeToAux, outputVarToConstraintNode,
+                 targetOutputVariableIndex, constantVar, numLayersInUse );
 
-        reluplex.initializeCell( it.second, targetOutputVariable, 1.0 );
-        reluplex.initializeCell( it.second, currentVar, -1.0 );
-    }
+    // The network, for symbolic and LP bound tightening (both off by default, see Reluplex.h)
+    AcasSymbolicBoundTightener symbolicBoundTightener( neuralNetwork, nodeToVars, numLayersInUse );
+    reluplex.setSymbolicBoundTightener( &symbolicBoundTightener );
 
     reluplex.setLogging( false );
     reluplex.setDumpStates( false );
@@ -327,30 +444,6 @@ int main( int argc, char **argv )
 
     try
     {
-        Vector<double> inputs;
-        Vector<double> outputs;
-
-        double totalError = 0.0;
-
-        //     Range min: 1500
-        //     Range max: 1800
-        reluplex.setLowerBound( nodeToVars[Index(0, 0, true)], normalizeInput( 0, 1500, neuralNetwork ) );
-        reluplex.setUpperBound( nodeToVars[Index(0, 0, true)], normalizeInput( 0, 1800, neuralNetwork ) );
-
-        //     Theta min: -0.06
-        //     Theta max: 0.06
-        reluplex.setLowerBound( nodeToVars[Index(0, 1, true)], normalizeInput( 1, -0.06, neuralNetwork ) );
-        reluplex.setUpperBound( nodeToVars[Index(0, 1, true)], normalizeInput( 1, 0.06, neuralNetwork ) );
-
-        //     Bearing min: 3.10
-        reluplex.setLowerBound( nodeToVars[Index(0, 2, true)], normalizeInput( 2, 3.10, neuralNetwork ) );
-
-        //     Speed own min: 980
-        reluplex.setLowerBound( nodeToVars[Index(0, 3, true)], normalizeInput( 3, 980, neuralNetwork ) );
-
-        //     Speed int min: 960
-        reluplex.setLowerBound( nodeToVars[Index(0, 4, true)], normalizeInput( 4, 960, neuralNetwork ) );
-
         printf( "\nReluplex input ranges are:\n" );
         for ( unsigned i = 0; i < inputLayerSize ; ++i )
         {
@@ -367,6 +460,7 @@ int main( int argc, char **argv )
         }
         printf( "\n\n" );
 
+        setIntervalBounds( reluplex, neuralNetwork, nodeToVars, numLayersInUse );
         reluplex.initialize();
 
         printf( "\nAfter reluplex initialization, output ranges are:\n" );
@@ -383,51 +477,7 @@ int main( int argc, char **argv )
         Reluplex::FinalStatus result = reluplex.solve();
         if ( result == Reluplex::SAT )
         {
-            printf( "Solution found!\n\n" );
-            for ( unsigned i = 0; i < inputLayerSize; ++i )
-            {
-                double assignment = reluplex.getAssignment( nodeToVars[Index(0, i, true)] );
-                printf( "input[%u] = %lf. Normalized: %lf.\n",
-                        i, unnormalizeInput( i, assignment, neuralNetwork ), assignment );
-                inputs.append( assignment );
-            }
-
-            printf( "\n" );
-            for ( unsigned i = 0; i < outputLayerSize; ++i )
-            {
-                printf( "output[%u] = %.10lf. Normalized: %lf\n", i,
-                        reluplex.getAssignment( nodeToVars[Index(numLayersInUse - 1, i, false)] ),
-                        normalizeOutput( reluplex.getAssignment( nodeToVars[Index(numLayersInUse - 1, i, false)] ),
-                                         neuralNetwork ) );
-            }
-
-            printf( "\nOutput using nnet:\n" );
-
-            neuralNetwork.evaluate( inputs, outputs, outputLayerSize );
-            unsigned i = 0;
-            for ( const auto &output : outputs )
-            {
-                printf( "output[%u] = %.10lf. Normalized: %lf\n", i, output,
-                        normalizeOutput( output, neuralNetwork ) );
-
-                totalError +=
-                    FloatUtils::abs( output -
-                                     reluplex.getAssignment( nodeToVars[Index(numLayersInUse - 1, i, false)] ) );
-
-                ++i;
-            }
-
-            printf( "\n" );
-            printf( "Total error: %.10lf. Average: %.10lf\n", totalError, totalError / outputLayerSize );
-            printf( "\n" );
-
-            printf( "Output slacks:\n" );
-            for ( const auto &it : outputVarToConstraintNode )
-            {
-                printf( "\tWith variable %u: %.10lf\n", it.first, reluplex.getAssignment( it.second ) );
-            }
-            printf( "\n" );
-
+            printSolution( reluplex, neuralNetwork, nodeToVars, outputVarToConstraintNode, numLayersInUse );
         }
         else if ( result == Reluplex::UNSAT )
         {
@@ -454,14 +504,7 @@ int main( int argc, char **argv )
     }
 
     end = Time::sampleMicro();
-
-    unsigned milliPassed = Time::timePassed( start, end );
-    unsigned seconds = milliPassed / 1000;
-    unsigned minutes = seconds / 60;
-    unsigned hours = minutes / 60;
-
-    printf( "Total run time: %u milli (%02u:%02u:%02u)\n",
-            Time::timePassed( start, end ), hours, minutes - ( hours * 60 ), seconds - ( minutes * 60 ) );
+    printRunTime( start, end );
 
 	return 0;
 }
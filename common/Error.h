@@ -93,6 +93,8 @@ public:
         LOWER_BOUND_IS_INFINITE = 69,
         UPPER_BOUND_IS_INFINITE = 70,
         CONSECUTIVE_GLPK_FAILURES = 71,
+        UNKNOWN_BRANCHING_HEURISTIC = 72,
+        UNKNOWN_RESTART_POLICY = 73,
     };
 
 	Error( Code code ) : _code( code )
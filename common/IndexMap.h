@@ -0,0 +1,172 @@
+/*********************                                                        */
+/*! \file IndexMap.h
+ ** \verbatim
+ ** Top contributors (to current version):
+ **   Guy Katz
+ ** This file is part of the Reluplex project.
+ ** Copyright (c) 2016-2017 by the authors listed in the file AUTHORS
+ ** (in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved. See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **/
+
+#ifndef __IndexMap_h__
+#define __IndexMap_h__
+
+#include "Error.h"
+#include "IndexSet.h"
+
+#include <utility>
+#include <vector>
+
+/*
+  A map whose keys are small non-negative integers, such as variable indices, kept as
+  an array indexed by key. Iteration yields (key, value) pairs in increasing key order,
+  as with Map<unsigned, Value>.
+*/
+template<class Value>
+class IndexMap
+{
+public:
+    class const_iterator
+    {
+    public:
+        const_iterator( const IndexMap *map, IndexSet::const_iterator key )
+            : _map( map )
+            , _key( key )
+        {
+        }
+
+        std::pair<unsigned, Value> operator*() const
+        {
+            return std::make_pair( *_key, _map->_values[*_key] );
+        }
+
+        const_iterator &operator++()
+        {
+            ++_key;
+            return *this;
+        }
+
+        bool operator==( const const_iterator &other ) const
+        {
+            return _key == other._key;
+        }
+
+        bool operator!=( const const_iterator &other ) const
+        {
+            return _key != other._key;
+        }
+
+    private:
+        const IndexMap *_map;
+        IndexSet::const_iterator _key;
+    };
+
+    typedef const_iterator iterator;
+
+    IndexMap( unsigned capacity = 0 )
+        : _keys( capacity )
+        , _values( capacity )
+    {
+    }
+
+    // Adds the key if it is missing
+    Value &operator[]( unsigned key )
+    {
+        if ( key >= _values.size() )
+            _values.resize( key + 1 );
+
+        if ( !_keys.exists( key ) )
+        {
+            _keys.insert( key );
+            _values[key] = Value();
+        }
+
+        return _values[key];
+    }
+
+    const Value &at( unsigned key ) const
+    {
+        if ( !exists( key ) )
+            throw Error( Error::KEY_DOESNT_EXIST_IN_MAP );
+
+        return _values[key];
+    }
+
+    Value get( unsigned key ) const
+    {
+        return at( key );
+    }
+
+    bool exists( unsigned key ) const
+    {
+        return _keys.exists( key );
+    }
+
+    void erase( unsigned key )
+    {
+        if ( !exists( key ) )
+            throw Error( Error::KEY_DOESNT_EXIST_IN_MAP );
+
+        _keys.erase( key );
+    }
+
+    unsigned size() const
+    {
+        return _keys.size();
+    }
+
+    bool empty() const
+    {
+        return _keys.empty();
+    }
+
+    void clear()
+    {
+        _keys.clear();
+    }
+
+    const_iterator begin() const
+    {
+        return const_iterator( this, _keys.begin() );
+    }
+
+    const_iterator end() const
+    {
+        return const_iterator( this, _keys.end() );
+    }
+
+    bool operator==( const IndexMap<Value> &other ) const
+    {
+        if ( _keys != other._keys )
+            return false;
+
+        for ( unsigned key : _keys )
+        {
+            if ( !( _values[key] == other._values[key] ) )
+                return false;
+        }
+
+        return true;
+    }
+
+    bool operator!=( const IndexMap<Value> &other ) const
+    {
+        return !( *this == other );
+    }
+
+private:
+    IndexSet _keys;
+    std::vector<Value> _values;
+};
+
+#endif // __IndexMap_h__
+
+//
+// Local Variables:
+// compile-command: "make -C . "
+// tags-file-name: "./TAGS"
+// c-basic-offset: 4
+// End:
+//
@@ -0,0 +1,174 @@
+/*********************                                                        */
+/*! \file IndexSet.h
+ ** \verbatim
+ ** Top contributors (to current version):
+ **   Guy Katz
+ ** This file is part of the Reluplex project.
+ ** Copyright (c) 2016-2017 by the authors listed in the file AUTHORS
+ ** (in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved. See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **/
+
+#ifndef __IndexSet_h__
+#define __IndexSet_h__
+
+#include <vector>
+
+/*
+  A set of small non-negative integers, such as variable indices, kept as one flag per
+  index. Lookups take constant time, and iteration is in increasing order, as with
+  Set<unsigned>. The set grows as needed to hold larger indices.
+*/
+class IndexSet
+{
+public:
+    class const_iterator
+    {
+    public:
+        const_iterator( const IndexSet *set, unsigned index )
+            : _set( set )
+            , _index( index )
+        {
+            skipMissing();
+        }
+
+        unsigned operator*() const
+        {
+            return _index;
+        }
+
+        const_iterator &operator++()
+        {
+            ++_index;
+            skipMissing();
+            return *this;
+        }
+
+        bool operator==( const const_iterator &other ) const
+        {
+            return _index == other._index;
+        }
+
+        bool operator!=( const const_iterator &other ) const
+        {
+            return _index != other._index;
+        }
+
+    private:
+        const IndexSet *_set;
+        unsigned _index;
+
+        void skipMissing()
+        {
+            while ( _index < _set->_present.size() && !_set->_present[_index] )
+                ++_index;
+        }
+    };
+
+    typedef const_iterator iterator;
+
+    IndexSet( unsigned capacity = 0 )
+        : _present( capacity, 0 )
+        , _size( 0 )
+    {
+    }
+
+    void insert( unsigned value )
+    {
+        if ( value >= _present.size() )
+            _present.resize( value + 1, 0 );
+
+        if ( !_present[value] )
+        {
+            _present[value] = 1;
+            ++_size;
+        }
+    }
+
+    void erase( unsigned value )
+    {
+        if ( exists( value ) )
+        {
+            _present[value] = 0;
+            --_size;
+        }
+    }
+
+    bool exists( unsigned value ) const
+    {
+        return value < _present.size() && _present[value];
+    }
+
+    unsigned size() const
+    {
+        return _size;
+    }
+
+    bool empty() const
+    {
+        return _size == 0;
+    }
+
+    void clear()
+    {
+        _present.assign( _present.size(), 0 );
+        _size = 0;
+    }
+
+    const_iterator begin() const
+    {
+        return const_iterator( this, 0 );
+    }
+
+    const_iterator end() const
+    {
+        return const_iterator( this, _present.size() );
+    }
+
+    bool operator==( const IndexSet &other ) const
+    {
+        if ( _size != other._size )
+            return false;
+
+        for ( unsigned value : *this )
+        {
+            if ( !other.exists( value ) )
+                return false;
+        }
+
+        return true;
+    }
+
+    bool operator!=( const IndexSet &other ) const
+    {
+        return !( *this == other );
+    }
+
+    // Elements that appear in one, but do not appear in two.
+    static IndexSet difference( const IndexSet &one, const IndexSet &two )
+    {
+        IndexSet difference( one._present.size() );
+        for ( unsigned value : one )
+        {
+            if ( !two.exists( value ) )
+                difference.insert( value );
+        }
+
+        return difference;
+    }
+
+private:
+    std::vector<char> _present;
+    unsigned _size;
+};
+
+#endif // __IndexSet_h__
+
+//
+// Local Variables:
+// compile-command: "make -C . "
+// tags-file-name: "./TAGS"
+// c-basic-offset: 4
+// End:
+//
@@ -0,0 +1,112 @@
+/*********************                                                        */
+/*! \file SparseIndexSet.h
+ ** \verbatim
+ ** Top contributors (to current version):
+ **   Guy Katz
+ ** This file is part of the Reluplex project.
+ ** Copyright (c) 2016-2017 by the authors listed in the file AUTHORS
+ ** (in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved. See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **/
+
+#ifndef __SparseIndexSet_h__
+#define __SparseIndexSet_h__
+
+#include <vector>
+
+/*
+  A set of small non-negative integers, such as variable indices, for sets that change
+  often and are picked from. The members are kept in a dense array, and every index has its
+  position in that array (0 if missing, position + 1 otherwise). Insertions, erasures,
+  lookups and picking a member all take constant time; erasing moves the last member into
+  the freed slot. Unlike IndexSet, iteration is in no particular order.
+*/
+class SparseIndexSet
+{
+public:
+    typedef std::vector<unsigned>::const_iterator const_iterator;
+    typedef const_iterator iterator;
+
+    SparseIndexSet( unsigned capacity = 0 )
+        : _position( capacity, 0 )
+    {
+        _members.reserve( capacity );
+    }
+
+    void insert( unsigned value )
+    {
+        if ( value >= _position.size() )
+            _position.resize( value + 1, 0 );
+
+        if ( _position[value] == 0 )
+        {
+            _members.push_back( value );
+            _position[value] = _members.size();
+        }
+    }
+
+    void erase( unsigned value )
+    {
+        if ( !exists( value ) )
+            return;
+
+        unsigned last = _members.back();
+        _members[_position[value] - 1] = last;
+        _position[last] = _position[value];
+        _members.pop_back();
+        _position[value] = 0;
+    }
+
+    bool exists( unsigned value ) const
+    {
+        return value < _position.size() && _position[value] != 0;
+    }
+
+    unsigned size() const
+    {
+        return _members.size();
+    }
+
+    bool empty() const
+    {
+        return _members.empty();
+    }
+
+    void clear()
+    {
+        for ( unsigned value : _members )
+            _position[value] = 0;
+        _members.clear();
+    }
+
+    // Some member of a non-empty set
+    unsigned pick() const
+    {
+        return _members.front();
+    }
+
+    const_iterator begin() const
+    {
+        return _members.begin();
+    }
+
+    const_iterator end() const
+    {
+        return _members.end();
+    }
+
+private:
+    std::vector<unsigned> _members;
+    std::vector<unsigned> _position;
+};
+
+#endif // __SparseIndexSet_h__
+
+//
+// Local Variables:
+// compile-command: "make -C . "
+// tags-file-name: "./TAGS"
+// c-basic-offset: 4
+// End:
+//
@@ -0,0 +1,141 @@
+/*********************                                                        */
+/*! \file ThreadPool.h
+ ** \verbatim
+ ** Top contributors (to current version):
+ **   Guy Katz
+ ** This file is part of the Reluplex project.
+ ** Copyright (c) 2016-2017 by the authors listed in the file AUTHORS
+ ** (in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved. See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **/
+
+#ifndef __ThreadPool_h__
+#define __ThreadPool_h__
+
+#include "Vector.h"
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+/*
+  A fixed set of worker threads that run the same job together. The calling thread
+  takes part as thread 0, so a pool of one thread runs everything on the caller.
+*/
+class ThreadPool
+{
+public:
+    typedef std::function<void( unsigned )> Job;
+
+    ThreadPool( unsigned numThreads )
+        : _numThreads( numThreads == 0 ? 1 : numThreads )
+        , _job( NULL )
+        , _generation( 0 )
+        , _pending( 0 )
+        , _quit( false )
+    {
+        for ( unsigned i = 1; i < _numThreads; ++i )
+            _workers.append( new std::thread( &ThreadPool::workerLoop, this, i ) );
+    }
+
+    ~ThreadPool()
+    {
+        {
+            std::unique_lock<std::mutex> lock( _mutex );
+            _quit = true;
+        }
+        _wakeUp.notify_all();
+
+        for ( unsigned i = 0; i < _workers.size(); ++i )
+        {
+            _workers[i]->join();
+            delete _workers[i];
+        }
+    }
+
+    unsigned getNumThreads() const
+    {
+        return _numThreads;
+    }
+
+    // Run job( thread ) on every thread of the pool, and return once they are all done
+    void run( const Job &job )
+    {
+        if ( _numThreads == 1 )
+        {
+            job( 0 );
+            return;
+        }
+
+        {
+            std::unique_lock<std::mutex> lock( _mutex );
+            _job = &job;
+            _pending = _numThreads - 1;
+            ++_generation;
+        }
+        _wakeUp.notify_all();
+
+        job( 0 );
+
+        std::unique_lock<std::mutex> lock( _mutex );
+        while ( _pending > 0 )
+            _done.wait( lock );
+        _job = NULL;
+    }
+
+private:
+    unsigned _numThreads;
+    Vector<std::thread *> _workers;
+
+    std::mutex _mutex;
+    std::condition_variable _wakeUp;
+    std::condition_variable _done;
+
+    const Job *_job;
+    unsigned long long _generation;
+    unsigned _pending;
+    bool _quit;
+
+    void workerLoop( unsigned thread )
+    {
+        unsigned long long lastGeneration = 0;
+
+        while ( true )
+        {
+            const Job *job;
+
+            {
+                std::unique_lock<std::mutex> lock( _mutex );
+                while ( !_quit && _generation == lastGeneration )
+                    _wakeUp.wait( lock );
+
+                if ( _quit )
+                    return;
+
+                lastGeneration = _generation;
+                job = _job;
+            }
+
+            ( *job )( thread );
+
+            {
+                std::unique_lock<std::mutex> lock( _mutex );
+                --_pending;
+                if ( _pending == 0 )
+                    _done.notify_one();
+            }
+        }
+    }
+};
+
+#endif // __ThreadPool_h__
+
+//
+// Local Variables:
+// compile-command: "make -C . "
+// tags-file-name: "./TAGS"
+// c-basic-offset: 4
+// End:
+//
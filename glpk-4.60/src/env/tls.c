@@ -23,9 +23,15 @@
 
 #include "env.h"
 
+#ifdef __GNUC__
+/* every thread has its own environment, so that several threads can
+ * work on different problem objects at the same time */
+static __thread void *tls = NULL;
+#else
 static void *tls = NULL;
 /* NOTE: in a re-entrant version of the package this variable should be
  * placed in the Thread Local Storage (TLS) */
+#endif
 
 /***********************************************************************
 *  NAME
@@ -507,6 +507,12 @@ void glp_init_smcp(glp_smcp *parm)
       parm->reportSoiCallback = NULL;
       parm->makeReluAdjustmentsCallback = NULL;
 
+      parm->callbackInfo = NULL;
+      parm->boundCalculationHookWithInfo = NULL;
+      parm->iterationCountCallbackWithInfo = NULL;
+      parm->reportSoiCallbackWithInfo = NULL;
+      parm->makeReluAdjustmentsCallbackWithInfo = NULL;
+
       return;
 }
 
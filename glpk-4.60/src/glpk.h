@@ -112,6 +112,13 @@ typedef void (* IterationCountCallback)( int count );
 typedef void (* ReportSoiCallback)( double soi );
 typedef int (* MakeReluAdjustmentsCallback)( int n, int m, int leavingBasic, const int *head, const char *flags );
 
+/* The same callbacks, also passed glp_smcp.callbackInfo. If both variants of a callback are
+   set, only the one with the info is called. */
+typedef void (* BoundCalculationHookWithInfo)( void *info, int n, int m, int *head, int leavingBasic, int enteringNonBasic, double *basicRow );
+typedef void (* IterationCountCallbackWithInfo)( void *info, int count );
+typedef void (* ReportSoiCallbackWithInfo)( void *info, double soi );
+typedef int (* MakeReluAdjustmentsCallbackWithInfo)( void *info, int n, int m, int leavingBasic, const int *head, const char *flags );
+
 
 typedef struct
 {     /* simplex method control parameters */
@@ -150,6 +157,12 @@ typedef struct
       ReportSoiCallback reportSoiCallback;
       MakeReluAdjustmentsCallback makeReluAdjustmentsCallback;
 
+      void *callbackInfo;
+      BoundCalculationHookWithInfo boundCalculationHookWithInfo;
+      IterationCountCallbackWithInfo iterationCountCallbackWithInfo;
+      ReportSoiCallbackWithInfo reportSoiCallbackWithInfo;
+      MakeReluAdjustmentsCallbackWithInfo makeReluAdjustmentsCallbackWithInfo;
+
       double foo_bar[36];     /* (reserved) */
 } glp_smcp;
 
@@ -159,6 +159,12 @@ struct SPXLP
       IterationCountCallback iterationCountCallback;
       ReportSoiCallback reportSoiCallback;
       MakeReluAdjustmentsCallback makeReluAdjustmentsCallback;
+
+      void *callbackInfo;
+      BoundCalculationHookWithInfo boundCalculationHookWithInfo;
+      IterationCountCallbackWithInfo iterationCountCallbackWithInfo;
+      ReportSoiCallbackWithInfo reportSoiCallbackWithInfo;
+      MakeReluAdjustmentsCallbackWithInfo makeReluAdjustmentsCallbackWithInfo;
 };
 
 #define spx_factorize _glp_spx_factorize
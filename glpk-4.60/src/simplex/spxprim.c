@@ -48,6 +48,44 @@
 #define CHECK_ACCURACY 0
 /* (for debugging) */
 
+/* Calls to the Reluplex callbacks, preferring the variants that take
+ * the callback info */
+
+static int has_relu_adjustments(SPXLP *lp)
+{     return lp->makeReluAdjustmentsCallbackWithInfo != NULL ||
+         lp->makeReluAdjustmentsCallback != NULL;
+}
+
+static int make_relu_adjustments(SPXLP *lp, int variable)
+{     if (lp->makeReluAdjustmentsCallbackWithInfo)
+         return (*(lp->makeReluAdjustmentsCallbackWithInfo))
+            (lp->callbackInfo, lp->n, lp->m, variable, lp->head, lp->flag);
+      return (*(lp->makeReluAdjustmentsCallback))
+         (lp->n, lp->m, variable, lp->head, lp->flag);
+}
+
+static void calculate_bounds(SPXLP *lp, int p, int q, double *trow)
+{     if (lp->boundCalculationHookWithInfo)
+         (*(lp->boundCalculationHookWithInfo))
+            (lp->callbackInfo, lp->n, lp->m, lp->head, p, q, trow);
+      else if (lp->boundCalculationHook)
+         (*(lp->boundCalculationHook))(lp->n, lp->m, lp->head, p, q, trow);
+}
+
+static void report_soi(SPXLP *lp, double soi)
+{     if (lp->reportSoiCallbackWithInfo)
+         (*(lp->reportSoiCallbackWithInfo))(lp->callbackInfo, soi);
+      else if (lp->reportSoiCallback)
+         (*(lp->reportSoiCallback))(soi);
+}
+
+static void report_iteration_count(SPXLP *lp, int count)
+{     if (lp->iterationCountCallbackWithInfo)
+         (*(lp->iterationCountCallbackWithInfo))(lp->callbackInfo, count);
+      else if (lp->iterationCountCallback)
+         (*(lp->iterationCountCallback))(count);
+}
+
 struct csa
 {     /* common storage area */
       SPXLP *lp;
@@ -908,8 +946,7 @@ loop: /* main loop starts here */
                if (msg_lev >= GLP_MSG_ALL)
                   xprintf("LP HAS NO PRIMAL FEASIBLE SOLUTION\n");
 
-	       if (lp->reportSoiCallback)
-		 (*(lp->reportSoiCallback))(sum_infeas(csa->lp, csa->beta));
+	       report_soi(lp, sum_infeas(csa->lp, csa->beta));
 
                csa->p_stat = GLP_NOFEAS;
                csa->d_stat = GLP_UNDEF; /* will be set below */
@@ -969,7 +1006,7 @@ loop: /* main loop starts here */
       csa->beta_st = 2;
 
       /* Maintain the RELU invariant if needed */
-      if ( lp->makeReluAdjustmentsCallback )
+      if ( has_relu_adjustments(lp) )
       {
       	// We may need to adjust the relu invariant.
       	// 1. If a pivot is going to occurr, we need to examine the LEAVING variable, p.
@@ -978,14 +1015,12 @@ loop: /* main loop starts here */
       	if (csa->p < 0)
       	{
       	  // No pivot is going to happen. Examine xN[q].
-      	  reluPartner = (*(lp->makeReluAdjustmentsCallback))( lp->n, lp->m,
-      							      head[lp->m + csa->q], lp->head, lp->flag );
+      	  reluPartner = make_relu_adjustments( lp, head[lp->m + csa->q] );
       	}
       	else
       	{
       	  // A pivot is going to happen. Examine xB[p].
-      	  reluPartner = (*(lp->makeReluAdjustmentsCallback))( lp->n, lp->m,
-      							      head[csa->p], lp->head, lp->flag );
+      	  reluPartner = make_relu_adjustments( lp, head[csa->p] );
       	}
 
 	xassert(MAINTAIN_RELU_INVARAINT);
@@ -1016,8 +1051,7 @@ loop: /* main loop starts here */
       else
          spx_nt_prod(lp, nt, trow, 1, -1.0, rho);
 
-      if ( lp->boundCalculationHook )
-	(*(lp->boundCalculationHook))( lp->n, lp->m, lp->head, csa->p, csa->q, trow );
+      calculate_bounds(lp, csa->p, csa->q, trow);
 
       /* FIXME: tcol[p] and trow[q] should be close to each other */
       // xassert(trow[csa->q] != 0.0);
@@ -1119,6 +1153,12 @@ int spx_primal(glp_prob *P, const glp_smcp *parm)
       lp.reportSoiCallback = parm->reportSoiCallback;
       lp.makeReluAdjustmentsCallback = parm->makeReluAdjustmentsCallback;
 
+      lp.callbackInfo = parm->callbackInfo;
+      lp.boundCalculationHookWithInfo = parm->boundCalculationHookWithInfo;
+      lp.iterationCountCallbackWithInfo = parm->iterationCountCallbackWithInfo;
+      lp.reportSoiCallbackWithInfo = parm->reportSoiCallbackWithInfo;
+      lp.makeReluAdjustmentsCallbackWithInfo = parm->makeReluAdjustmentsCallbackWithInfo;
+
       spx_alloc_lp(csa->lp);
       map = talloc(1+P->m+P->n, int);
       spx_build_lp(csa->lp, P, EXCL, SHIFT, map);
@@ -1211,8 +1251,7 @@ int spx_primal(glp_prob *P, const glp_smcp *parm)
       /* try to solve working LP */
       ret = primal_simplex(csa);
 
-      if ( lp.iterationCountCallback )
-	(*(lp.iterationCountCallback))(csa->it_cnt);
+      report_iteration_count(&lp, csa->it_cnt);
 
       /* return basis factorization back to problem object */
       P->valid = csa->lp->valid;
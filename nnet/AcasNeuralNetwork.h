@@ -89,6 +89,99 @@ public:
         return (unsigned)_network->layerSizes[layer];
     }
 
+    /*
+      Interval arithmetic, one layer at a time. Given bounds on the (normalized) inputs, compute
+      bounds on the weighted sum of every neuron, before its ReLU is applied. Entry i of
+      lowerBounds and upperBounds holds layer i; layer 0 is the inputs, and the last layer has
+      no ReLU.
+    */
+    void computeIntervalBounds( const Vector<double> &inputLowerBounds,
+                                const Vector<double> &inputUpperBounds,
+                                Vector<Vector<double> > &lowerBounds,
+                                Vector<Vector<double> > &upperBounds )
+    {
+        lowerBounds.clear();
+        upperBounds.clear();
+        lowerBounds.append( inputLowerBounds );
+        upperBounds.append( inputUpperBounds );
+
+        for ( int layer = 1; layer <= getNumLayers(); ++layer )
+        {
+            const Vector<double> &sourceLower( lowerBounds[layer - 1] );
+            const Vector<double> &sourceUpper( upperBounds[layer - 1] );
+            Vector<double> layerLower;
+            Vector<double> layerUpper;
+
+            for ( unsigned target = 0; target < getLayerSize( layer ); ++target )
+            {
+                double lower = getBias( layer, target );
+                double upper = lower;
+
+                for ( unsigned source = 0; source < getLayerSize( layer - 1 ); ++source )
+                {
+                    double sourceMin = sourceLower.get( source );
+                    double sourceMax = sourceUpper.get( source );
+
+                    // Neurons of hidden layers feed forward through their ReLUs
+                    if ( layer > 1 )
+                    {
+                        sourceMin = sourceMin > 0 ? sourceMin : 0;
+                        sourceMax = sourceMax > 0 ? sourceMax : 0;
+                    }
+
+                    double weight = getWeight( layer - 1, source, target );
+                    if ( weight > 0 )
+                    {
+                        lower += weight * sourceMin;
+                        upper += weight * sourceMax;
+                    }
+                    else
+                    {
+                        lower += weight * sourceMax;
+                        upper += weight * sourceMin;
+                    }
+                }
+
+                layerLower.append( lower );
+                layerUpper.append( upper );
+            }
+
+            lowerBounds.append( layerLower );
+            upperBounds.append( layerUpper );
+        }
+    }
+
+    /*
+      For every input, a bound on how fast the outputs can change with it: the sum, over all
+      paths from the input to an output, of the product of the absolute weights along the path.
+      ReLUs only make the actual change smaller.
+    */
+    void computeInputSensitivity( Vector<double> &sensitivity )
+    {
+        Vector<double> current;
+        for ( unsigned i = 0; i < getLayerSize( getNumLayers() ); ++i )
+            current.append( 1.0 );
+
+        for ( int layer = getNumLayers(); layer > 0; --layer )
+        {
+            Vector<double> previous;
+            for ( unsigned source = 0; source < getLayerSize( layer - 1 ); ++source )
+            {
+                double sum = 0.0;
+                for ( unsigned target = 0; target < getLayerSize( layer ); ++target )
+                {
+                    double weight = getWeight( layer - 1, source, target );
+                    sum += ( weight > 0 ? weight : -weight ) * current.get( target );
+                }
+                previous.append( sum );
+            }
+
+            current = previous;
+        }
+
+        sensitivity = current;
+    }
+
     void evaluate( const Vector<double> &inputs, Vector<double> &outputs, unsigned outputSize ) const
     {
         double input[inputs.size()];
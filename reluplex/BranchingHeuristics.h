@@ -0,0 +1,286 @@
+/*********************                                                        */
+/*! \file BranchingHeuristics.h
+ ** \verbatim
+ ** Top contributors (to current version):
+ **   Guy Katz
+ ** This file is part of the Reluplex project.
+ ** Copyright (c) 2016-2017 by the authors listed in the file AUTHORS
+ ** (in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved. See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **/
+
+#ifndef __BranchingHeuristics_h__
+#define __BranchingHeuristics_h__
+
+#include "Error.h"
+#include "IReluplex.h"
+#include "MStringf.h"
+#include "Map.h"
+#include "ReluPairs.h"
+
+// Activity scores are bumped by an increment that grows by this factor after every decision,
+// so that older bumps count for less
+static const double ACTIVITY_DECAY = 0.95;
+
+/*
+  Once a broken ReLU pair has been fixed NUM_RELU_OPERATIONS_BEFORE_SPLIT times, the SmtCore
+  splits on a ReLU pair. A branching heuristic chooses which of the currently broken pairs
+  that will be (by its f variable).
+*/
+class BranchingHeuristic
+{
+public:
+    enum Type {
+        // The pair that reached the limit (the original Reluplex behavior)
+        REPEATEDLY_BROKEN = 0,
+        // The pair in the earliest layer of the network, as given by IReluplex::getReluLayer()
+        EARLIEST_LAYER = 1,
+        // The pair whose b variable has the widest bounds
+        WIDEST_INTERVAL = 2,
+        // The pair that was fixed most often since solving started
+        MOST_VIOLATIONS = 3,
+        // The pair that was fixed, or was involved in conflicts, most often lately
+        ACTIVITY = 4,
+    };
+
+    static BranchingHeuristic *create( Type type );
+
+    virtual ~BranchingHeuristic() {}
+
+    virtual Type getType() const = 0;
+    virtual const char *getName() const = 0;
+
+    // Called whenever a broken pair is about to be fixed
+    virtual void notifyBrokenRelu( unsigned /* f */ )
+    {
+    }
+
+    // Called when the first phase chosen for a pair led to a conflict
+    virtual void notifyConflict( unsigned /* f */ )
+    {
+    }
+
+    // Pick the pair to split on. f is the pair that reached the limit.
+    virtual unsigned pickSplitVariable( IReluplex *reluplex, unsigned f ) = 0;
+};
+
+class RepeatedlyBrokenHeuristic : public BranchingHeuristic
+{
+public:
+    Type getType() const
+    {
+        return REPEATEDLY_BROKEN;
+    }
+
+    const char *getName() const
+    {
+        return "repeatedly broken";
+    }
+
+    unsigned pickSplitVariable( IReluplex * /* reluplex */, unsigned f )
+    {
+        return f;
+    }
+};
+
+/*
+  The heuristics below score every broken pair and pick the one with the highest score.
+  Ties go to the pair that reached the limit, and then to the lowest b variable.
+*/
+class ScoringHeuristic : public BranchingHeuristic
+{
+public:
+    unsigned pickSplitVariable( IReluplex *reluplex, unsigned f )
+    {
+        ReluPairs *reluPairs = reluplex->getReluPairs();
+
+        unsigned best = f;
+        double bestScore = score( reluplex, f );
+
+        // The broken pairs come in no particular order, so ties are broken explicitly
+        for ( unsigned b : reluplex->getBrokenReluBs() )
+        {
+            unsigned candidate = reluPairs->bToF( b );
+            double candidateScore = score( reluplex, candidate );
+            bool tie = ( candidateScore == bestScore ) && ( best != f ) && ( b < reluPairs->fToB( best ) );
+            if ( candidateScore > bestScore || tie )
+            {
+                best = candidate;
+                bestScore = candidateScore;
+            }
+        }
+
+        return best;
+    }
+
+protected:
+    virtual double score( IReluplex *reluplex, unsigned f ) = 0;
+};
+
+class EarliestLayerHeuristic : public ScoringHeuristic
+{
+public:
+    Type getType() const
+    {
+        return EARLIEST_LAYER;
+    }
+
+    const char *getName() const
+    {
+        return "earliest layer";
+    }
+
+protected:
+    double score( IReluplex *reluplex, unsigned f )
+    {
+        return -(double)reluplex->getReluLayer( f );
+    }
+};
+
+class WidestIntervalHeuristic : public ScoringHeuristic
+{
+public:
+    Type getType() const
+    {
+        return WIDEST_INTERVAL;
+    }
+
+    const char *getName() const
+    {
+        return "widest interval";
+    }
+
+protected:
+    double score( IReluplex *reluplex, unsigned f )
+    {
+        unsigned b = reluplex->getReluPairs()->fToB( f );
+        return reluplex->getUpperBound( b ) - reluplex->getLowerBound( b );
+    }
+};
+
+class MostViolationsHeuristic : public ScoringHeuristic
+{
+public:
+    Type getType() const
+    {
+        return MOST_VIOLATIONS;
+    }
+
+    const char *getName() const
+    {
+        return "most violations";
+    }
+
+    // Unlike the SmtCore's counters, these are not reset after every split
+    void notifyBrokenRelu( unsigned f )
+    {
+        if ( !_violations.exists( f ) )
+            _violations[f] = 0;
+        ++_violations[f];
+    }
+
+protected:
+    double score( IReluplex * /* reluplex */, unsigned f )
+    {
+        return _violations.exists( f ) ? _violations[f] : 0;
+    }
+
+private:
+    Map<unsigned, unsigned long long> _violations;
+};
+
+class ActivityHeuristic : public ScoringHeuristic
+{
+public:
+    ActivityHeuristic()
+        : _increment( 1.0 )
+    {
+    }
+
+    Type getType() const
+    {
+        return ACTIVITY;
+    }
+
+    const char *getName() const
+    {
+        return "activity";
+    }
+
+    void notifyBrokenRelu( unsigned f )
+    {
+        bump( f );
+    }
+
+    void notifyConflict( unsigned f )
+    {
+        bump( f );
+    }
+
+    unsigned pickSplitVariable( IReluplex *reluplex, unsigned f )
+    {
+        unsigned result = ScoringHeuristic::pickSplitVariable( reluplex, f );
+
+        // Decay all scores, by making future bumps larger
+        _increment /= ACTIVITY_DECAY;
+        if ( _increment > 1e100 )
+        {
+            for ( auto &activity : _activity )
+                activity.second *= 1e-100;
+            _increment *= 1e-100;
+        }
+
+        return result;
+    }
+
+protected:
+    double score( IReluplex * /* reluplex */, unsigned f )
+    {
+        return _activity.exists( f ) ? _activity[f] : 0.0;
+    }
+
+private:
+    Map<unsigned, double> _activity;
+    double _increment;
+
+    void bump( unsigned f )
+    {
+        if ( !_activity.exists( f ) )
+            _activity[f] = 0.0;
+        _activity[f] += _increment;
+    }
+};
+
+inline BranchingHeuristic *BranchingHeuristic::create( Type type )
+{
+    switch ( type )
+    {
+    case REPEATEDLY_BROKEN:
+        return new RepeatedlyBrokenHeuristic;
+
+    case EARLIEST_LAYER:
+        return new EarliestLayerHeuristic;
+
+    case WIDEST_INTERVAL:
+        return new WidestIntervalHeuristic;
+
+    case MOST_VIOLATIONS:
+        return new MostViolationsHeuristic;
+
+    case ACTIVITY:
+        return new ActivityHeuristic;
+    }
+
+    throw Error( Error::UNKNOWN_BRANCHING_HEURISTIC, Stringf( "Heuristic: %u", type ).ascii() );
+}
+
+#endif // __BranchingHeuristics_h__
+
+//
+// Local Variables:
+// compile-command: "make -C . "
+// tags-file-name: "./TAGS"
+// c-basic-offset: 4
+// End:
+//
@@ -16,6 +16,7 @@
 #include "IReluplex.h"
 #include "List.h"
 #include "Pair.h"
+#include "SolverLog.h"
 #include "TimeUtils.h"
 #include "glpk.h"
 
@@ -28,13 +29,14 @@ public:
         NO_SOLUTION_EXISTS,
     };
 
-    GlpkWrapper()
+    GlpkWrapper( SolverLog *log )
         : _nextGlpkInternalIndex( 1 )
+        , _callbackInfo( NULL )
         , _boundCalculationHook( NULL )
         , _iterationCountCallback( NULL )
         , _reportSoiCallback( NULL )
         , _makeReluAdjustmentsCallback( NULL )
-        , _logging( false )
+        , _log( log )
     {
         _lp = glp_create_prob();
         glp_set_prob_name( _lp, "reluplex" );
@@ -46,17 +48,9 @@ public:
         glp_delete_prob( _lp );
     }
 
-    void log( String message )
-    {
-        if ( !_logging )
-            return;
-
-        printf( "GlpkWrapper: %s", message.ascii() );
-    }
-
     GlpkAnswer run( const IReluplex &reluplex )
     {
-        log( "Starting\n" );
+        SOLVER_LOG( *_log, LOG_GLPK, LOG_DEBUG, "Starting\n" );
 
         addRows( reluplex );
         addColumns( reluplex );
@@ -66,14 +60,14 @@ public:
 
         GlpkAnswer answer = solve();
 
-        log( "Done\n" );
+        SOLVER_LOG( *_log, LOG_GLPK, LOG_DEBUG, "Done\n" );
 
         return answer;
     }
 
     void addRows( const IReluplex &reluplex )
     {
-        Set<unsigned> basicVariables = reluplex.getBasicVariables();
+        const IndexSet &basicVariables = reluplex.getBasicVariables();
         Set<unsigned> activeSlackRows = reluplex.getActiveRowSlacks();
 
         glp_add_rows( _lp, basicVariables.size() + activeSlackRows.size() );
@@ -128,7 +122,7 @@ public:
 
     void addColumns( const IReluplex &reluplex )
     {
-        Set<unsigned> basicVariables = reluplex.getBasicVariables();
+        const IndexSet &basicVariables = reluplex.getBasicVariables();
         Set<unsigned> eliminatedVars = reluplex.getEliminatedVars();
         Set<unsigned> activeSlackCols = reluplex.getActiveColSlacks();
 
@@ -248,7 +242,7 @@ public:
     {
         const Tableau *tableau = reluplex.getTableau();
 
-        Set<unsigned> basicVariables = reluplex.getBasicVariables();
+        const IndexSet &basicVariables = reluplex.getBasicVariables();
         Set<unsigned> activeRowSlacks = reluplex.getActiveRowSlacks();
 
         unsigned totalSize = tableau->totalSize() * 3;
@@ -263,18 +257,18 @@ public:
             // Work on row i
             unsigned rowIndex = _basicToRowIndex[basic];
 
-            const Tableau::Entry *row = tableau->getRow( basic );
-            const Tableau::Entry *current;
-            while ( row != NULL )
+            Tableau::Iterator row = tableau->getRow( basic );
+            Tableau::Iterator current;
+            while ( !row.atEnd() )
             {
                 current = row;
-                row = row->nextInRow();
+                row.advance();
 
-                if ( current->getColumn() != basic )
+                if ( current.getColumn() != basic )
                 {
                     ia[entryIndex] = rowIndex;
-                    ja[entryIndex] = _nonBasicToColumnIndex[current->getColumn()];
-                    ar[entryIndex] = current->getValue();
+                    ja[entryIndex] = _nonBasicToColumnIndex[current.getColumn()];
+                    ar[entryIndex] = current.getValue();
 
                     ++entryIndex;
                 }
@@ -307,22 +301,28 @@ public:
         delete []ar;
     }
 
-    void setBoundCalculationHook( BoundCalculationHook hook )
+    // Passed to every callback below
+    void setCallbackInfo( void *info )
+    {
+        _callbackInfo = info;
+    }
+
+    void setBoundCalculationHook( BoundCalculationHookWithInfo hook )
     {
         _boundCalculationHook = hook;
     }
 
-    void setIterationCountCallback( IterationCountCallback callback )
+    void setIterationCountCallback( IterationCountCallbackWithInfo callback )
     {
         _iterationCountCallback = callback;
     }
 
-    void setReportSoiCallback( ReportSoiCallback callback )
+    void setReportSoiCallback( ReportSoiCallbackWithInfo callback )
     {
         _reportSoiCallback = callback;
     }
 
-    void setMakeReluAdjustmentCallback( MakeReluAdjustmentsCallback callback )
+    void setMakeReluAdjustmentCallback( MakeReluAdjustmentsCallbackWithInfo callback )
     {
         _makeReluAdjustmentsCallback = callback;
     }
@@ -344,19 +344,20 @@ public:
         controlParameters.it_lim = 100000;
 
         controlParameters.presolve = 0;
+        controlParameters.callbackInfo = _callbackInfo;
         if ( _boundCalculationHook )
-            controlParameters.boundCalculationHook = _boundCalculationHook;
+            controlParameters.boundCalculationHookWithInfo = _boundCalculationHook;
         if ( _iterationCountCallback )
-            controlParameters.iterationCountCallback = _iterationCountCallback;
+            controlParameters.iterationCountCallbackWithInfo = _iterationCountCallback;
         if ( _reportSoiCallback )
-            controlParameters.reportSoiCallback = _reportSoiCallback;
+            controlParameters.reportSoiCallbackWithInfo = _reportSoiCallback;
         if ( _makeReluAdjustmentsCallback )
-            controlParameters.makeReluAdjustmentsCallback = _makeReluAdjustmentsCallback;
+            controlParameters.makeReluAdjustmentsCallbackWithInfo = _makeReluAdjustmentsCallback;
 
         retValue = glp_simplex( _lp, &controlParameters );
         if ( retValue != 0 )
         {
-            log( "Invocation of Glpk failed!\n" );
+            SOLVER_LOG( *_log, LOG_GLPK, LOG_DEBUG, "Invocation of Glpk failed!\n" );
 
             switch ( retValue )
             {
@@ -426,13 +427,13 @@ public:
 
         if ( glp_get_prim_stat( _lp ) == GLP_FEAS )
         {
-            log( "A feasible solution has been found!\n" );
+            SOLVER_LOG( *_log, LOG_GLPK, LOG_DEBUG, "A feasible solution has been found!\n" );
             return SOLUTION_FOUND;
         }
 
         if ( glp_get_prim_stat( _lp ) == GLP_NOFEAS )
         {
-            log( "No feasible solution exists!\n" );
+            SOLVER_LOG( *_log, LOG_GLPK, LOG_DEBUG, "No feasible solution exists!\n" );
             return NO_SOLUTION_EXISTS;
         }
 
@@ -460,7 +461,7 @@ public:
         }
     }
 
-    void extractBasicVariables( const IReluplex &reluplex, Set<unsigned> &basics )
+    void extractBasicVariables( const IReluplex &reluplex, IndexSet &basics )
     {
         Set<unsigned> activeSlackRows = reluplex.getActiveRowSlacks();
         Set<unsigned> activeSlackCols = reluplex.getActiveColSlacks();
@@ -484,7 +485,7 @@ public:
 
     void extractTableau( IReluplex *reluplex,
                          Tableau *matrix,
-                         Set<unsigned> *basicVariables,
+                         IndexSet *basicVariables,
                          Set<unsigned> *eliminatedVars )
     {
         if ( !reluplex->getActiveRowSlacks().empty() || !reluplex->getActiveColSlacks().empty() )
@@ -494,7 +495,7 @@ public:
         }
 
         unsigned numVars = matrix->getNumVars();
-        Set<unsigned> originalBasicVariables = *basicVariables;
+        IndexSet originalBasicVariables = *basicVariables;
 
         basicVariables->clear();
         matrix->deleteAllEntries();
@@ -521,20 +522,21 @@ private:
     Map<unsigned, unsigned> _glpkEncodingToVariable;
     Map<unsigned, unsigned> _variableToGlpkEncoding;
 
-    BoundCalculationHook _boundCalculationHook;
-    IterationCountCallback _iterationCountCallback;
-    ReportSoiCallback _reportSoiCallback;
-    MakeReluAdjustmentsCallback _makeReluAdjustmentsCallback;
+    void *_callbackInfo;
+    BoundCalculationHookWithInfo _boundCalculationHook;
+    IterationCountCallbackWithInfo _iterationCountCallback;
+    ReportSoiCallbackWithInfo _reportSoiCallback;
+    MakeReluAdjustmentsCallbackWithInfo _makeReluAdjustmentsCallback;
 
     int *_columnIndices;
     double *_values;
 
-    bool _logging;
+    SolverLog *_log;
 
     void extractVariableRow( IReluplex *reluplex,
                              unsigned var,
                              Tableau *matrix,
-                             Set<unsigned> *basicVariables )
+                             IndexSet *basicVariables )
     {
         unsigned glpkEncoding = _variableToGlpkEncoding[var];
 
@@ -565,7 +567,7 @@ private:
                           unsigned colSlackVar,
                           Map<unsigned, double> &row )
     {
-        Set<unsigned> basicVariables = reluplex.getBasicVariables();
+        const IndexSet &basicVariables = reluplex.getBasicVariables();
         const Tableau *tableau = reluplex.getTableau();
 
         // Every slack variable has the equation f-b-colSlack.
@@ -580,17 +582,17 @@ private:
         else
         {
             // F is basic, so we need to add its entire row
-            const Tableau::Entry *rowPointer = tableau->getRow( f );
-            const Tableau::Entry *current;
-            while ( rowPointer != NULL )
+            Tableau::Iterator rowPointer = tableau->getRow( f );
+            Tableau::Iterator current;
+            while ( !rowPointer.atEnd() )
             {
                 current = rowPointer;
-                rowPointer = rowPointer->nextInRow();
+                rowPointer.advance();
 
-                if ( current->getColumn() != f )
+                if ( current.getColumn() != f )
                 {
-                    unsigned column = current->getColumn();
-                    double weight = current->getValue();
+                    unsigned column = current.getColumn();
+                    double weight = current.getValue();
 
                     if ( !row.exists( column ) ) row[column] = 0.0;
                     row[column] += weight;
@@ -606,17 +608,17 @@ private:
         else
         {
             // B is basic, so we need to add its entire row, negated
-            const Tableau::Entry *rowPointer = tableau->getRow( b );
-            const Tableau::Entry *current;
-            while ( rowPointer != NULL )
+            Tableau::Iterator rowPointer = tableau->getRow( b );
+            Tableau::Iterator current;
+            while ( !rowPointer.atEnd() )
             {
                 current = rowPointer;
-                rowPointer = rowPointer->nextInRow();
+                rowPointer.advance();
 
-                if ( current->getColumn() != b )
+                if ( current.getColumn() != b )
                 {
-                    unsigned column = current->getColumn();
-                    double weight = current->getValue();
+                    unsigned column = current.getColumn();
+                    double weight = current.getValue();
 
                     if ( !row.exists( column ) ) row[column] = 0.0;
                     row[column] += -weight;
@@ -14,15 +14,17 @@
 #define __IReluplex_h__
 
 #include "FloatUtils.h"
+#include "IndexSet.h"
 #include "List.h"
 #include "Map.h"
 #include "Pair.h"
 #include "Set.h"
+#include "SparseIndexSet.h"
 #include "Tableau.h"
 #include "MString.h"
+#include "VariableBound.h"
 
 class ReluPairs;
-class VariableBound;
 
 class IReluplex
 {
@@ -69,19 +71,22 @@ public:
     virtual double getLowerBound( unsigned var ) const = 0;
     virtual const VariableBound *getUpperBounds() const = 0;
     virtual double getUpperBound( unsigned var ) const = 0;
-    virtual Set<unsigned> getBasicVariables() const = 0;
+    virtual const IndexSet &getBasicVariables() const = 0;
     virtual const double *getAssignment() const = 0;
     virtual double getAssignment( unsigned var ) const = 0;
     virtual ReluPairs *getReluPairs() = 0;
     virtual bool reluPairIsBroken( unsigned b, unsigned f ) const = 0;
+    virtual const SparseIndexSet &getBrokenReluBs() const = 0;
+    virtual unsigned getReluLayer( unsigned f ) const = 0;
 
     virtual bool activeReluVariable( unsigned variable ) const = 0;
 
-    virtual const Tableau::Entry *getColumn( unsigned column ) const = 0;
-    virtual const Tableau::Entry *getRow( unsigned column ) const = 0;
+    virtual Tableau::Iterator getColumn( unsigned column ) const = 0;
+    virtual Tableau::Iterator getRow( unsigned column ) const = 0;
     virtual double getCell( unsigned row, unsigned column ) const = 0;
 
     virtual bool isDissolvedBVariable( unsigned variable ) const = 0;
+    virtual bool isDissolvedReluPair( unsigned f, ReluDissolutionType &type ) const = 0;
     virtual unsigned countSplits() const = 0;
     virtual unsigned countMerges() const = 0;
 
@@ -95,24 +100,25 @@ public:
 
     virtual void computeVariableStatus() = 0;
 
-    virtual void setLowerBounds( const List<VariableBound> &lowerBounds ) = 0;
-    virtual void setUpperBounds( const List<VariableBound> &upperBounds ) = 0;
-    virtual void setBasicVariables( const Set<unsigned> &basicVariables ) = 0;
-    virtual void setAssignment( const List<double> &assignment ) = 0;
+    virtual void setBasicVariables( const IndexSet &basicVariables ) = 0;
+    virtual void setAssignment( const double *assignment ) = 0;
     virtual void setReluPairs( const ReluPairs &reluPairs ) = 0;
     virtual void updateUpperBound( unsigned variable, double bound, unsigned level ) = 0;
     virtual bool updateLowerBound( unsigned variable, double bound, unsigned level ) = 0;
+    virtual void updateUpperBound( unsigned variable, double bound, unsigned level, DecisionSet decisions ) = 0;
+    virtual bool updateLowerBound( unsigned variable, double bound, unsigned level, DecisionSet decisions ) = 0;
 
     virtual void backupIntoMatrix( Tableau *matrix ) const = 0;
     virtual void restoreFromMatrix( Tableau *matrix ) = 0;
 
     virtual void togglePrintAssignment( bool value ) = 0;
     virtual void conflictAnalysisCausedPop() = 0;
+    virtual bool probeReluPhases() = 0;
 
     virtual unsigned getColumnSize( unsigned column ) const = 0;
 
-    virtual Map<unsigned, ReluDissolutionType> getDissolvedReluPairs() const = 0;
-    virtual void setDissolvedReluPairs( const Map<unsigned, ReluDissolutionType> &pairs ) = 0;
+    virtual unsigned getTrailSize() const = 0;
+    virtual void undoTrail( unsigned trailSize ) = 0;
     virtual void setUseApproximation( bool value ) = 0;
     virtual void setFindAllPivotCandidates( bool value ) = 0;
 
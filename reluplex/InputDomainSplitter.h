@@ -0,0 +1,555 @@
+/*********************                                                        */
+/*! \file InputDomainSplitter.h
+ ** \verbatim
+ ** Top contributors (to current version):
+ **   Guy Katz
+ ** This file is part of the Reluplex project.
+ ** Copyright (c) 2016-2017 by the authors listed in the file AUTHORS
+ ** (in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved. See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **/
+
+#ifndef __InputDomainSplitter_h__
+#define __InputDomainSplitter_h__
+
+#include "File.h"
+#include "List.h"
+#include "MStringf.h"
+#include "Reluplex.h"
+#include "ThreadPool.h"
+#include "TimeUtils.h"
+#include "Vector.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+
+// Number of threads that the drivers use to solve input boxes in parallel. 0 means the whole
+// query is solved by a single Reluplex. Build with INPUT_SPLITTING_THREADS=<n> to change.
+#ifdef INPUT_SPLITTING_THREADS
+static const unsigned DEFAULT_INPUT_SPLITTING_THREADS = INPUT_SPLITTING_THREADS;
+#else
+static const unsigned DEFAULT_INPUT_SPLITTING_THREADS = 0;
+#endif
+
+// A box that is not solved within this many milliseconds is bisected, and its halves are
+// solved instead. Build with INPUT_SPLITTING_BUDGET=<milliseconds> to change.
+#ifdef INPUT_SPLITTING_BUDGET
+static const unsigned DEFAULT_INPUT_SPLITTING_BUDGET_MILLI = INPUT_SPLITTING_BUDGET;
+#else
+static const unsigned DEFAULT_INPUT_SPLITTING_BUDGET_MILLI = 60000;
+#endif
+
+// Boxes that were bisected this many times are solved without a budget, so that the search
+// always ends
+static const unsigned INPUT_SPLITTING_MAX_DEPTH = 16;
+
+// How often budgets and cancellation are checked
+static const unsigned INPUT_SPLITTING_MONITOR_INTERVAL_MILLI = 50;
+
+// A box in the input space of the network, over the normalized inputs
+struct InputBox
+{
+    InputBox()
+        : _depth( 0 )
+    {
+    }
+
+    Vector<double> _lowerBounds;
+    Vector<double> _upperBounds;
+
+    // The number of bisections that led to this box
+    unsigned _depth;
+};
+
+/*
+  Solve a query by splitting its input region into boxes that are solved independently, each
+  by its own Reluplex. The query is SAT if any box is SAT, and UNSAT if all of them are.
+
+  The boxes are solved on a pool of worker threads. Every worker keeps a deque of boxes: it
+  takes boxes from the front of its own deque, and when it runs out it steals from the back of
+  the others', where the older and larger boxes are. The calling thread does not solve boxes;
+  it monitors the workers, and quits every Reluplex whose box has used up its time budget.
+  Such a box is bisected and its halves go to the front of the worker's deque.
+
+  Boxes are bisected at the middle of their most influential input: the one whose width,
+  times the sensitivity of the network to that input, is largest. The sensitivities are given
+  by the driver; see AcasNeuralNetwork::computeInputSensitivity().
+
+  The first SAT box cancels all other work. The Reluplex that found it is kept, so that the
+  driver can read the satisfying assignment from it.
+*/
+class InputDomainSplitter
+{
+public:
+    /*
+      The query restricted to one box, built by the driver. Besides the Reluplex it holds
+      anything that must live as long as it does, e.g. its symbolic bound tightener.
+    */
+    class Query
+    {
+    public:
+        virtual ~Query() {}
+        virtual Reluplex &getReluplex() = 0;
+    };
+
+    typedef std::function<Query *( const InputBox &box )> QueryFactory;
+
+    InputDomainSplitter( const QueryFactory &queryFactory,
+                         const Vector<double> &sensitivity,
+                         unsigned numThreads = DEFAULT_INPUT_SPLITTING_THREADS,
+                         unsigned budgetMilli = DEFAULT_INPUT_SPLITTING_BUDGET_MILLI )
+        : _queryFactory( queryFactory )
+        , _sensitivity( sensitivity )
+        , _numWorkers( numThreads == 0 ? 1 : numThreads )
+        , _budgetMilli( budgetMilli )
+        , _workers( NULL )
+        , _pendingBoxes( 0 )
+        , _done( false )
+        , _cancelled( false )
+        , _foundError( false )
+        , _satisfyingQuery( NULL )
+        , _finalStatus( Reluplex::NOT_DONE )
+        , _numBoxesRun( 0 )
+        , _numUnsatBoxes( 0 )
+        , _numBoxesBisected( 0 )
+        , _numSteals( 0 )
+        , _maxDepth( 0 )
+        , _maximalStackDepth( 0 )
+        , _numStatesExplored( 0 )
+        , _totalTimeMilli( 0 )
+    {
+        _workers = new Worker[_numWorkers];
+    }
+
+    ~InputDomainSplitter()
+    {
+        if ( _satisfyingQuery )
+        {
+            delete _satisfyingQuery;
+            _satisfyingQuery = NULL;
+        }
+
+        if ( _workers )
+        {
+            delete[] _workers;
+            _workers = NULL;
+        }
+    }
+
+    Reluplex::FinalStatus solve( const InputBox &box )
+    {
+        timeval start = Time::sampleMicro();
+
+        // Bisect up front, so that every worker starts with a box of its own
+        List<InputBox> initialBoxes;
+        initialBoxes.append( box );
+        while ( initialBoxes.size() < _numWorkers )
+        {
+            InputBox first;
+            InputBox second;
+            if ( !bisect( *initialBoxes.begin(), first, second ) )
+                break;
+
+            initialBoxes.erase( initialBoxes.begin() );
+            initialBoxes.append( first );
+            initialBoxes.append( second );
+        }
+
+        unsigned worker = 0;
+        for ( const auto &initialBox : initialBoxes )
+        {
+            _workers[worker]._boxes.append( initialBox );
+            worker = ( worker + 1 ) % _numWorkers;
+        }
+        _pendingBoxes = initialBoxes.size();
+
+        printf( "Input domain splitting: %u workers, %u initial boxes, budget of %u milli per box\n",
+                _numWorkers, initialBoxes.size(), _budgetMilli );
+
+        // Thread 0 is the caller, which monitors the others
+        ThreadPool threadPool( _numWorkers + 1 );
+        threadPool.run( [this]( unsigned thread )
+                        {
+                            if ( thread == 0 )
+                                monitor();
+                            else
+                                work( thread - 1 );
+                        } );
+
+        if ( _satisfyingQuery )
+            _finalStatus = Reluplex::SAT;
+        else if ( _cancelled )
+            _finalStatus = Reluplex::NOT_DONE;
+        else if ( _foundError )
+            _finalStatus = Reluplex::ERROR;
+        else
+            _finalStatus = Reluplex::UNSAT;
+
+        _totalTimeMilli = Time::timePassed( start, Time::sampleMicro() );
+        return _finalStatus;
+    }
+
+    // Stop all work. Only sets a flag, so this may be called from a signal handler.
+    void quit()
+    {
+        _cancelled = true;
+    }
+
+    // The Reluplex that found the query SAT, or NULL
+    Reluplex *getSatisfyingReluplex()
+    {
+        return _satisfyingQuery ? &_satisfyingQuery->getReluplex() : NULL;
+    }
+
+    unsigned long long numStatesExplored() const
+    {
+        return _numStatesExplored;
+    }
+
+    void printStatistics() const
+    {
+        printf( "\nInput domain splitting: %u boxes run (%u UNSAT), %u bisected after "
+                "the budget ran out, deepest box: %u. Steals: %u. Total visited states: %llu\n",
+                _numBoxesRun, _numUnsatBoxes, _numBoxesBisected, _maxDepth, _numSteals,
+                _numStatesExplored );
+    }
+
+    // Append a line in the format of Reluplex::printFinalStatistics(), covering all boxes
+    void printFinalStatistics( const char *finalOutputFile, const String &name ) const
+    {
+        try
+        {
+            File outputFile( finalOutputFile );
+            outputFile.open( IFile::MODE_WRITE_APPEND );
+
+            outputFile.write( name + ", " );
+
+            String status;
+            switch ( _finalStatus )
+            {
+            case Reluplex::SAT:
+                status = "SAT";
+                break;
+
+            case Reluplex::UNSAT:
+                status = "UNSAT";
+                break;
+
+            case Reluplex::ERROR:
+                status = "ERROR";
+                break;
+
+            case Reluplex::NOT_DONE:
+                status = "TIMEOUT";
+                break;
+            }
+
+            outputFile.write( status + ", " );
+            outputFile.write( Stringf( "%llu, %s, ", _totalTimeMilli, milliToString( _totalTimeMilli ).ascii() ) );
+            outputFile.write( Stringf( "%u, ", _maximalStackDepth ) );
+            outputFile.write( Stringf( "%llu\n", _numStatesExplored ) );
+        }
+        catch( ... )
+        {
+            printf( "Final staitstics printing threw an error!\n" );
+        }
+    }
+
+private:
+    struct Worker
+    {
+        Worker()
+            : _query( NULL )
+            , _budgeted( false )
+            , _budgetExhausted( false )
+        {
+        }
+
+        // Guards everything below
+        std::mutex _mutex;
+
+        List<InputBox> _boxes;
+
+        // The query currently being solved, and when it started
+        Query *_query;
+        timeval _start;
+        bool _budgeted;
+        bool _budgetExhausted;
+    };
+
+    QueryFactory _queryFactory;
+    Vector<double> _sensitivity;
+    unsigned _numWorkers;
+    unsigned _budgetMilli;
+    Worker *_workers;
+
+    // Guards _pendingBoxes, the results and the statistics
+    std::mutex _mutex;
+    std::condition_variable _wakeUp;
+
+    // Boxes that are waiting in some deque or being solved
+    unsigned _pendingBoxes;
+
+    std::atomic<bool> _done;
+    std::atomic<bool> _cancelled;
+    bool _foundError;
+    Query *_satisfyingQuery;
+    Reluplex::FinalStatus _finalStatus;
+
+    // Statistics
+    unsigned _numBoxesRun;
+    unsigned _numUnsatBoxes;
+    unsigned _numBoxesBisected;
+    unsigned _numSteals;
+    unsigned _maxDepth;
+    unsigned _maximalStackDepth;
+    unsigned long long _numStatesExplored;
+    unsigned long long _totalTimeMilli;
+
+    // Return false if the box is a single point
+    bool bisect( const InputBox &box, InputBox &first, InputBox &second ) const
+    {
+        unsigned dimension = 0;
+        double bestScore = 0.0;
+        for ( unsigned i = 0; i < box._lowerBounds.size(); ++i )
+        {
+            double score = box._upperBounds.get( i ) - box._lowerBounds.get( i );
+            if ( i < _sensitivity.size() )
+                score *= _sensitivity.get( i );
+
+            if ( score > bestScore )
+            {
+                dimension = i;
+                bestScore = score;
+            }
+        }
+
+        if ( !FloatUtils::isPositive( bestScore ) )
+            return false;
+
+        double middle = ( box._lowerBounds.get( dimension ) + box._upperBounds.get( dimension ) ) / 2;
+
+        first = box;
+        second = box;
+        first._upperBounds[dimension] = middle;
+        second._lowerBounds[dimension] = middle;
+        ++first._depth;
+        ++second._depth;
+
+        return true;
+    }
+
+    bool takeBox( unsigned worker, InputBox &box )
+    {
+        {
+            Worker &own( _workers[worker] );
+            std::unique_lock<std::mutex> lock( own._mutex );
+            if ( !own._boxes.empty() )
+            {
+                box = *own._boxes.begin();
+                own._boxes.erase( own._boxes.begin() );
+                return true;
+            }
+        }
+
+        for ( unsigned i = 1; i < _numWorkers; ++i )
+        {
+            Worker &victim( _workers[( worker + i ) % _numWorkers] );
+            std::unique_lock<std::mutex> lock( victim._mutex );
+            if ( !victim._boxes.empty() )
+            {
+                List<InputBox>::iterator last = --victim._boxes.end();
+                box = *last;
+                victim._boxes.erase( last );
+
+                std::unique_lock<std::mutex> statisticsLock( _mutex );
+                ++_numSteals;
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    void work( unsigned worker )
+    {
+        while ( !_done )
+        {
+            InputBox box;
+            if ( takeBox( worker, box ) )
+            {
+                solveBox( worker, box );
+                continue;
+            }
+
+            // Wait for a bisection to produce more boxes, or for the others to finish
+            std::unique_lock<std::mutex> lock( _mutex );
+            if ( !_done )
+                _wakeUp.wait_for( lock, std::chrono::milliseconds( INPUT_SPLITTING_MONITOR_INTERVAL_MILLI ) );
+        }
+    }
+
+    void solveBox( unsigned worker, const InputBox &box )
+    {
+        Worker &self( _workers[worker] );
+        Query *query = NULL;
+        Reluplex::FinalStatus status = Reluplex::NOT_DONE;
+        bool budgetExhausted = false;
+
+        // Once cancelled, the remaining boxes are just drained
+        if ( !_cancelled )
+        {
+            query = _queryFactory( box );
+            Reluplex &reluplex( query->getReluplex() );
+
+            {
+                std::unique_lock<std::mutex> lock( self._mutex );
+                self._query = query;
+                self._start = Time::sampleMicro();
+                self._budgeted = ( box._depth < INPUT_SPLITTING_MAX_DEPTH );
+                self._budgetExhausted = false;
+            }
+
+            // The monitor may have missed this query
+            if ( _cancelled )
+                reluplex.quit();
+
+            status = reluplex.solve();
+
+            std::unique_lock<std::mutex> lock( self._mutex );
+            self._query = NULL;
+            budgetExhausted = self._budgetExhausted;
+        }
+
+        InputBox first;
+        InputBox second;
+        bool bisected = false;
+        bool retried = false;
+        if ( status == Reluplex::NOT_DONE && budgetExhausted && !_cancelled )
+        {
+            bisected = bisect( box, first, second );
+
+            // A single point cannot be bisected, so solve it again without a budget
+            if ( !bisected )
+            {
+                first = box;
+                first._depth = INPUT_SPLITTING_MAX_DEPTH;
+                retried = true;
+            }
+        }
+
+        if ( bisected || retried )
+        {
+            std::unique_lock<std::mutex> lock( self._mutex );
+            if ( bisected )
+                self._boxes.appendHead( second );
+            self._boxes.appendHead( first );
+        }
+
+        std::unique_lock<std::mutex> lock( _mutex );
+
+        if ( query )
+        {
+            Reluplex &reluplex( query->getReluplex() );
+
+            ++_numBoxesRun;
+            _numStatesExplored += reluplex.numStatesExplored();
+            if ( reluplex.getMaximalStackDepth() > _maximalStackDepth )
+                _maximalStackDepth = reluplex.getMaximalStackDepth();
+            if ( box._depth > _maxDepth )
+                _maxDepth = box._depth;
+
+            switch ( status )
+            {
+            case Reluplex::SAT:
+                if ( !_satisfyingQuery )
+                {
+                    printf( "Input domain splitting: box at depth %u is SAT, cancelling all other boxes\n",
+                            box._depth );
+                    _satisfyingQuery = query;
+                    query = NULL;
+                }
+                _cancelled = true;
+                break;
+
+            case Reluplex::UNSAT:
+                ++_numUnsatBoxes;
+                break;
+
+            case Reluplex::ERROR:
+                _foundError = true;
+                break;
+
+            case Reluplex::NOT_DONE:
+                break;
+            }
+        }
+
+        if ( bisected )
+        {
+            ++_numBoxesBisected;
+            _pendingBoxes += 2;
+        }
+        else if ( retried )
+        {
+            ++_pendingBoxes;
+        }
+
+        --_pendingBoxes;
+        if ( _pendingBoxes == 0 )
+            _done = true;
+
+        _wakeUp.notify_all();
+        lock.unlock();
+
+        if ( query )
+            delete query;
+    }
+
+    void monitor()
+    {
+        while ( !_done )
+        {
+            {
+                std::unique_lock<std::mutex> lock( _mutex );
+                if ( !_done )
+                    _wakeUp.wait_for( lock, std::chrono::milliseconds( INPUT_SPLITTING_MONITOR_INTERVAL_MILLI ) );
+            }
+
+            timeval now = Time::sampleMicro();
+            for ( unsigned i = 0; i < _numWorkers; ++i )
+            {
+                Worker &worker( _workers[i] );
+                std::unique_lock<std::mutex> lock( worker._mutex );
+                if ( !worker._query )
+                    continue;
+
+                if ( _cancelled )
+                {
+                    worker._query->getReluplex().quit();
+                }
+                else if ( worker._budgeted &&
+                          !worker._budgetExhausted &&
+                          Time::timePassed( worker._start, now ) > _budgetMilli )
+                {
+                    worker._budgetExhausted = true;
+                    worker._query->getReluplex().quit();
+                }
+            }
+        }
+    }
+};
+
+#endif // __InputDomainSplitter_h__
+
+//
+// Local Variables:
+// compile-command: "make -C . "
+// tags-file-name: "./TAGS"
+// c-basic-offset: 4
+// End:
+//
@@ -0,0 +1,415 @@
+/*********************                                                        */
+/*! \file LpBoundTightener.h
+ ** \verbatim
+ ** Top contributors (to current version):
+ **   Guy Katz
+ ** This file is part of the Reluplex project.
+ ** Copyright (c) 2016-2017 by the authors listed in the file AUTHORS
+ ** (in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved. See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **/
+
+#ifndef __LpBoundTightener_h__
+#define __LpBoundTightener_h__
+
+#include "FloatUtils.h"
+#include "SymbolicBoundTightener.h"
+#include "ThreadPool.h"
+#include "VariableBound.h"
+#include "glpk.h"
+
+// The optimal values found by GLPK are only accurate up to its tolerances, so the bounds
+// are loosened by this much
+static const double LP_BOUND_TIGHTENING_MARGIN = 0.001;
+
+// Iteration limit for a single LP
+static const unsigned LP_BOUND_TIGHTENING_ITERATION_LIMIT = 10000;
+
+/*
+  Bounds for the neurons of the network described by a SymbolicBoundTightener, computed by
+  linear programming. The layers are handled in order: the b variables of a layer are
+  minimized and maximized subject to the weighted sums of all earlier layers, where each
+  ReLU whose phase is not known is replaced by its triangle relaxation. The new bounds of
+  a layer are then used for relaxing its ReLUs in the LPs of the following layers.
+
+  The neurons of a layer do not depend on each other, so they are divided among threads.
+  Each thread builds its own GLPK problem for the layer, and re-solves it for each of its
+  neurons with a different objective. This requires GLPK to keep a separate environment
+  for every thread (see glpk-4.60/src/env/tls.c).
+*/
+class LpBoundTightener
+{
+public:
+    LpBoundTightener( const SymbolicBoundTightener &network, unsigned numThreads )
+        : _network( network )
+        , _numLayers( network.getNumLayers() )
+        , _threadPool( numThreads )
+        , _lowerBounds( NULL )
+        , _upperBounds( NULL )
+        , _numLpsSolved( 0 )
+        , _numLpsFailed( 0 )
+    {
+        _neuronLowerBounds = new double *[_numLayers];
+        _neuronUpperBounds = new double *[_numLayers];
+
+        for ( unsigned layer = 0; layer < _numLayers; ++layer )
+        {
+            _neuronLowerBounds[layer] = new double[_network.getLayerSize( layer )];
+            _neuronUpperBounds[layer] = new double[_network.getLayerSize( layer )];
+        }
+
+        _threadLpsSolved = new unsigned[_threadPool.getNumThreads()];
+        _threadLpsFailed = new unsigned[_threadPool.getNumThreads()];
+    }
+
+    ~LpBoundTightener()
+    {
+        for ( unsigned layer = 0; layer < _numLayers; ++layer )
+        {
+            delete[] _neuronLowerBounds[layer];
+            delete[] _neuronUpperBounds[layer];
+        }
+
+        delete[] _neuronLowerBounds;
+        delete[] _neuronUpperBounds;
+        delete[] _threadLpsSolved;
+        delete[] _threadLpsFailed;
+    }
+
+    // The bounds computed for the b variable of a neuron by the last call to run()
+    double getLowerBound( unsigned layer, unsigned neuron ) const
+    {
+        return _neuronLowerBounds[layer][neuron];
+    }
+
+    double getUpperBound( unsigned layer, unsigned neuron ) const
+    {
+        return _neuronUpperBounds[layer][neuron];
+    }
+
+    unsigned getNumLpsSolved() const
+    {
+        return _numLpsSolved;
+    }
+
+    unsigned getNumLpsFailed() const
+    {
+        return _numLpsFailed;
+    }
+
+    void run( const VariableBound *lowerBounds, const VariableBound *upperBounds )
+    {
+        _lowerBounds = lowerBounds;
+        _upperBounds = upperBounds;
+
+        for ( unsigned layer = 0; layer < _numLayers; ++layer )
+        {
+            for ( unsigned neuron = 0; neuron < _network.getLayerSize( layer ); ++neuron )
+            {
+                unsigned b = _network.getBVariable( layer, neuron );
+                _neuronLowerBounds[layer][neuron] = _lowerBounds[b].getBound();
+                _neuronUpperBounds[layer][neuron] = _upperBounds[b].getBound();
+            }
+        }
+
+        unsigned numThreads = _threadPool.getNumThreads();
+        for ( unsigned thread = 0; thread < numThreads; ++thread )
+        {
+            _threadLpsSolved[thread] = 0;
+            _threadLpsFailed[thread] = 0;
+        }
+
+        // The bounds of a layer only change once all of its LPs have been solved
+        for ( unsigned layer = 1; layer < _numLayers; ++layer )
+        {
+            unsigned size = _network.getLayerSize( layer );
+            double *lower = new double[size];
+            double *upper = new double[size];
+
+            _threadPool.run( [this, layer, lower, upper]( unsigned thread )
+            {
+                optimizeLayer( layer, thread, lower, upper );
+
+                // The worker threads' GLPK environments are not needed anymore
+                if ( thread != 0 )
+                    glp_free_env();
+            } );
+
+            for ( unsigned neuron = 0; neuron < size; ++neuron )
+            {
+                if ( lower[neuron] > _neuronLowerBounds[layer][neuron] )
+                    _neuronLowerBounds[layer][neuron] = lower[neuron];
+                if ( upper[neuron] < _neuronUpperBounds[layer][neuron] )
+                    _neuronUpperBounds[layer][neuron] = upper[neuron];
+            }
+
+            delete[] lower;
+            delete[] upper;
+        }
+
+        _numLpsSolved = 0;
+        _numLpsFailed = 0;
+        for ( unsigned thread = 0; thread < numThreads; ++thread )
+        {
+            _numLpsSolved += _threadLpsSolved[thread];
+            _numLpsFailed += _threadLpsFailed[thread];
+        }
+    }
+
+private:
+    const SymbolicBoundTightener &_network;
+    unsigned _numLayers;
+    ThreadPool _threadPool;
+
+    // The variable bounds given to run()
+    const VariableBound *_lowerBounds;
+    const VariableBound *_upperBounds;
+
+    double **_neuronLowerBounds;
+    double **_neuronUpperBounds;
+
+    unsigned _numLpsSolved;
+    unsigned _numLpsFailed;
+    unsigned *_threadLpsSolved;
+    unsigned *_threadLpsFailed;
+
+    LpBoundTightener( const LpBoundTightener & );
+    LpBoundTightener &operator=( const LpBoundTightener & );
+
+    /*
+      The columns of the LP for a layer are the b and f variables of all the layers up to
+      it, layer by layer: the inputs, then the b's and f's of each hidden layer, and finally
+      the b's of the layer itself. Column indices start from 1, per GLPK rules.
+    */
+    void computeColumns( unsigned targetLayer, unsigned *bColumns, unsigned *fColumns, unsigned &numColumns ) const
+    {
+        numColumns = 0;
+
+        bColumns[0] = 1;
+        fColumns[0] = 1;
+        numColumns += _network.getLayerSize( 0 );
+
+        for ( unsigned layer = 1; layer <= targetLayer; ++layer )
+        {
+            bColumns[layer] = numColumns + 1;
+            numColumns += _network.getLayerSize( layer );
+
+            if ( layer < targetLayer )
+            {
+                fColumns[layer] = numColumns + 1;
+                numColumns += _network.getLayerSize( layer );
+            }
+        }
+    }
+
+    static void setColumnBounds( glp_prob *lp, unsigned column, double lower, double upper )
+    {
+        if ( FloatUtils::areEqual( lower, upper ) )
+            glp_set_col_bnds( lp, column, GLP_FX, lower, lower );
+        else
+            glp_set_col_bnds( lp, column, GLP_DB, lower, upper );
+    }
+
+    glp_prob *buildProblem( unsigned targetLayer, unsigned *bColumns ) const
+    {
+        unsigned *fColumns = new unsigned[targetLayer + 1];
+        unsigned numColumns;
+        computeColumns( targetLayer, bColumns, fColumns, numColumns );
+
+        glp_prob *lp = glp_create_prob();
+        glp_add_cols( lp, numColumns );
+
+        // Each weighted sum has one entry per source neuron, plus b. Each relaxed ReLU has two rows.
+        unsigned maxEntries = 1;
+        for ( unsigned layer = 1; layer <= targetLayer; ++layer )
+        {
+            unsigned size = _network.getLayerSize( layer );
+            maxEntries += size * ( _network.getLayerSize( layer - 1 ) + 1 );
+            if ( layer < targetLayer )
+                maxEntries += size * 4;
+        }
+
+        int *ia = new int[maxEntries];
+        int *ja = new int[maxEntries];
+        double *ar = new double[maxEntries];
+        unsigned entry = 1;
+        unsigned row = 0;
+
+        for ( unsigned neuron = 0; neuron < _network.getLayerSize( 0 ); ++neuron )
+            setColumnBounds( lp, bColumns[0] + neuron,
+                             _neuronLowerBounds[0][neuron], _neuronUpperBounds[0][neuron] );
+
+        for ( unsigned layer = 1; layer <= targetLayer; ++layer )
+        {
+            unsigned size = _network.getLayerSize( layer );
+            unsigned previousSize = _network.getLayerSize( layer - 1 );
+
+            for ( unsigned neuron = 0; neuron < size; ++neuron )
+            {
+                double lb = _neuronLowerBounds[layer][neuron];
+                double ub = _neuronUpperBounds[layer][neuron];
+                unsigned bColumn = bColumns[layer] + neuron;
+                setColumnBounds( lp, bColumn, lb, ub );
+
+                // b - sum( weight * f ) = bias
+                row = glp_add_rows( lp, 1 );
+                double bias = _network.getBias( layer, neuron );
+                glp_set_row_bnds( lp, row, GLP_FX, bias, bias );
+
+                ia[entry] = row;
+                ja[entry] = bColumn;
+                ar[entry] = 1.0;
+                ++entry;
+
+                for ( unsigned source = 0; source < previousSize; ++source )
+                {
+                    double weight = _network.getWeight( layer - 1, source, neuron );
+                    if ( weight == 0.0 )
+                        continue;
+
+                    ia[entry] = row;
+                    ja[entry] = fColumns[layer - 1] + source;
+                    ar[entry] = -weight;
+                    ++entry;
+                }
+
+                if ( layer == targetLayer )
+                    continue;
+
+                unsigned f = _network.getFVariable( layer, neuron );
+                unsigned fColumn = fColumns[layer] + neuron;
+
+                double fLower = _lowerBounds[f].getBound();
+                double fUpper = _upperBounds[f].getBound();
+                if ( fLower < 0.0 )
+                    fLower = 0.0;
+                if ( fLower < lb )
+                    fLower = lb;
+                if ( fUpper > ub && ub > 0.0 )
+                    fUpper = ub;
+                if ( ub <= 0.0 )
+                    fUpper = 0.0;
+                if ( fUpper < fLower )
+                    fUpper = fLower;
+                setColumnBounds( lp, fColumn, fLower, fUpper );
+
+                // An inactive ReLU is captured by the bounds of f
+                if ( ub <= 0.0 )
+                    continue;
+
+                // f - b >= 0, and f = b for an active ReLU
+                row = glp_add_rows( lp, 1 );
+                if ( lb >= 0.0 )
+                    glp_set_row_bnds( lp, row, GLP_FX, 0.0, 0.0 );
+                else
+                    glp_set_row_bnds( lp, row, GLP_LO, 0.0, 0.0 );
+
+                ia[entry] = row;
+                ja[entry] = fColumn;
+                ar[entry] = 1.0;
+                ++entry;
+                ia[entry] = row;
+                ja[entry] = bColumn;
+                ar[entry] = -1.0;
+                ++entry;
+
+                if ( lb >= 0.0 )
+                    continue;
+
+                // f <= ub * ( b - lb ) / ( ub - lb )
+                double slope = ub / ( ub - lb );
+                row = glp_add_rows( lp, 1 );
+                glp_set_row_bnds( lp, row, GLP_UP, 0.0, -slope * lb );
+
+                ia[entry] = row;
+                ja[entry] = fColumn;
+                ar[entry] = 1.0;
+                ++entry;
+                ia[entry] = row;
+                ja[entry] = bColumn;
+                ar[entry] = -slope;
+                ++entry;
+            }
+        }
+
+        glp_load_matrix( lp, entry - 1, ia, ja, ar );
+
+        delete[] ia;
+        delete[] ja;
+        delete[] ar;
+        delete[] fColumns;
+
+        return lp;
+    }
+
+    // Returns false if no optimal solution was found
+    bool optimize( glp_prob *lp, const glp_smcp &controlParameters, int direction, double &value )
+    {
+        glp_set_obj_dir( lp, direction );
+
+        if ( glp_simplex( lp, &controlParameters ) != 0 || glp_get_status( lp ) != GLP_OPT )
+            return false;
+
+        value = glp_get_obj_val( lp );
+        return true;
+    }
+
+    // Each thread takes every numThreads-th neuron of the layer
+    void optimizeLayer( unsigned layer, unsigned thread, double *lower, double *upper )
+    {
+        unsigned numThreads = _threadPool.getNumThreads();
+        if ( thread >= _network.getLayerSize( layer ) )
+            return;
+
+        unsigned *bColumns = new unsigned[layer + 1];
+        glp_prob *lp = buildProblem( layer, bColumns );
+
+        glp_smcp controlParameters;
+        glp_init_smcp( &controlParameters );
+        controlParameters.msg_lev = GLP_MSG_OFF;
+        controlParameters.it_lim = LP_BOUND_TIGHTENING_ITERATION_LIMIT;
+
+        for ( unsigned neuron = thread; neuron < _network.getLayerSize( layer ); neuron += numThreads )
+        {
+            lower[neuron] = _neuronLowerBounds[layer][neuron];
+            upper[neuron] = _neuronUpperBounds[layer][neuron];
+
+            // Each solve starts from the basis of the previous one
+            unsigned column = bColumns[layer] + neuron;
+            glp_set_obj_coef( lp, column, 1.0 );
+
+            double value;
+            if ( optimize( lp, controlParameters, GLP_MIN, value ) )
+            {
+                ++_threadLpsSolved[thread];
+                lower[neuron] = value - LP_BOUND_TIGHTENING_MARGIN;
+            }
+            else
+                ++_threadLpsFailed[thread];
+
+            if ( optimize( lp, controlParameters, GLP_MAX, value ) )
+            {
+                ++_threadLpsSolved[thread];
+                upper[neuron] = value + LP_BOUND_TIGHTENING_MARGIN;
+            }
+            else
+                ++_threadLpsFailed[thread];
+
+            glp_set_obj_coef( lp, column, 0.0 );
+        }
+
+        glp_delete_prob( lp );
+        delete[] bColumns;
+    }
+};
+
+#endif // __LpBoundTightener_h__
+
+//
+// Local Variables:
+// compile-command: "make -C . "
+// tags-file-name: "./TAGS"
+// c-basic-offset: 4
+// End:
+//
@@ -0,0 +1,188 @@
+/*********************                                                        */
+/*! \file NogoodDatabase.h
+ ** \verbatim
+ ** Top contributors (to current version):
+ **   Guy Katz
+ ** This file is part of the Reluplex project.
+ ** Copyright (c) 2016-2017 by the authors listed in the file AUTHORS
+ ** (in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved. See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **/
+
+#ifndef __NogoodDatabase_h__
+#define __NogoodDatabase_h__
+
+#include "IReluplex.h"
+#include "List.h"
+#include "Map.h"
+#include "Vector.h"
+
+// Longer nogoods rarely become unit and are not worth keeping
+static const unsigned MAX_NOGOOD_LENGTH = 20;
+
+/*
+  A nogood is a set of ReLU phases that cannot all hold together: the SmtCore learns one from
+  the decisions that led to every conflict. A literal stands for a pair, given by its f
+  variable, dissolved in a certain way. It is true if the pair is currently dissolved that way,
+  false if it is dissolved the other way, and unassigned otherwise.
+
+  Every nogood watches two of its literals that are not true. When a watched literal becomes
+  true another one is looked for; if there is none, the last watched literal is reported as
+  forced to be false, or a conflict if it is true as well.
+
+  The watches are not restored when the search backtracks. Popping only unassigns literals, so
+  the watches stay valid, but a nogood may then become unit without being noticed: this loses
+  propagations, never correctness.
+*/
+class NogoodDatabase
+{
+public:
+    enum LiteralValue {
+        LITERAL_TRUE,
+        LITERAL_FALSE,
+        LITERAL_UNASSIGNED,
+    };
+
+    static unsigned literal( unsigned f, IReluplex::ReluDissolutionType type )
+    {
+        return 2 * f + ( type == IReluplex::TYPE_MERGE ? 1 : 0 );
+    }
+
+    static unsigned literalToF( unsigned literal )
+    {
+        return literal / 2;
+    }
+
+    static IReluplex::ReluDissolutionType literalToType( unsigned literal )
+    {
+        return ( literal % 2 ) ? IReluplex::TYPE_MERGE : IReluplex::TYPE_SPLIT;
+    }
+
+    static unsigned negate( unsigned literal )
+    {
+        return literal ^ 1;
+    }
+
+    NogoodDatabase( const IReluplex *reluplex )
+        : _reluplex( reluplex )
+        , _numDropped( 0 )
+    {
+    }
+
+    LiteralValue value( unsigned literal ) const
+    {
+        IReluplex::ReluDissolutionType type;
+        if ( !_reluplex->isDissolvedReluPair( literalToF( literal ), type ) )
+            return LITERAL_UNASSIGNED;
+
+        return type == literalToType( literal ) ? LITERAL_TRUE : LITERAL_FALSE;
+    }
+
+    /*
+      Add a nogood. The literals should be ordered by decreasing decision level, so that the
+      two watched ones (the first two) are the last to be unassigned by backtracking.
+      Return false if the nogood was too long to keep.
+    */
+    bool addNogood( const Vector<unsigned> &literals )
+    {
+        if ( literals.empty() || literals.size() > MAX_NOGOOD_LENGTH )
+        {
+            ++_numDropped;
+            return false;
+        }
+
+        unsigned index = _nogoods.size();
+        _nogoods.append( literals );
+
+        _watches[literals.get( 0 )].append( index );
+        if ( literals.size() > 1 )
+            _watches[literals.get( 1 )].append( index );
+
+        return true;
+    }
+
+    /*
+      Called when literal has become true. Literals that must now be false are added to forced.
+      Return false if a nogood has all of its literals true.
+    */
+    bool propagate( unsigned literal, List<unsigned> &forced )
+    {
+        if ( !_watches.exists( literal ) )
+            return true;
+
+        List<unsigned> &watchers = _watches[literal];
+        List<unsigned>::iterator it = watchers.begin();
+        while ( it != watchers.end() )
+        {
+            Vector<unsigned> &nogood = _nogoods[*it];
+
+            if ( nogood.size() == 1 )
+                return false;
+
+            // Keep the triggering literal second
+            if ( nogood[0] == literal )
+            {
+                nogood[0] = nogood[1];
+                nogood[1] = literal;
+            }
+
+            bool moved = false;
+            for ( unsigned i = 2; i < nogood.size(); ++i )
+            {
+                if ( value( nogood[i] ) != LITERAL_TRUE )
+                {
+                    nogood[1] = nogood[i];
+                    nogood[i] = literal;
+                    _watches[nogood[1]].append( *it );
+                    it = watchers.erase( it );
+                    moved = true;
+                    break;
+                }
+            }
+
+            if ( moved )
+                continue;
+
+            LiteralValue other = value( nogood[0] );
+            if ( other == LITERAL_TRUE )
+                return false;
+
+            if ( other == LITERAL_UNASSIGNED )
+                forced.append( nogood[0] );
+
+            ++it;
+        }
+
+        return true;
+    }
+
+    unsigned getNumNogoods() const
+    {
+        return _nogoods.size();
+    }
+
+    unsigned getNumDropped() const
+    {
+        return _numDropped;
+    }
+
+private:
+    const IReluplex *_reluplex;
+    Vector<Vector<unsigned>> _nogoods;
+
+    // Literal to the indices of the nogoods watching it
+    Map<unsigned, List<unsigned>> _watches;
+
+    unsigned _numDropped;
+};
+
+#endif // __NogoodDatabase_h__
+
+//
+// Local Variables:
+// compile-command: "make -C . "
+// tags-file-name: "./TAGS"
+// c-basic-offset: 4
+// End:
+//
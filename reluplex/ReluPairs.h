@@ -13,7 +13,8 @@
 #ifndef __ReluPairs_h__
 #define __ReluPairs_h__
 
-#include "Map.h"
+#include "IndexMap.h"
+#include "Set.h"
 #include "MStringf.h"
 
 class ReluPairs
@@ -144,8 +145,8 @@ public:
 
 private:
     Set<ReluPair> _reluPairs;
-    Map<unsigned, unsigned> _bToF;
-    Map<unsigned, unsigned> _fToB;
+    IndexMap<unsigned> _bToF;
+    IndexMap<unsigned> _fToB;
 };
 
 #endif // __ReluPairs_h__
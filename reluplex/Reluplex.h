@@ -18,17 +18,27 @@
 #include "FloatUtils.h"
 #include "GlpkWrapper.h"
 #include "IReluplex.h"
+#include "IndexMap.h"
+#include "IndexSet.h"
+#include "LpBoundTightener.h"
 #include "Map.h"
 #include "Queue.h"
 #include "ReluPairs.h"
 #include "Set.h"
+#include "SparseIndexSet.h"
 #include "Tableau.h"
 #include "Stack.h"
 #include "SmtCore.h"
+#include "SolverLog.h"
+#include "SymbolicBoundTightener.h"
 #include "MStringf.h"
+#include "Queue.h"
+#include "ThreadPool.h"
 #include "TimeUtils.h"
 #include "VariableBound.h"
+#include <atomic>
 #include <string.h>
+#include <sys/resource.h>
 
 static const double ALMOST_BROKEN_RELU_MARGIN = 0.001;
 static const double GLPK_IMPRECISION_TOLERANCE = 0.001;
@@ -43,25 +53,104 @@ static const unsigned PRINT_ASSIGNMENT = 500;
 // How many times GLPK is allowed to fail before tableau restoration
 static const unsigned MAX_GLPK_FAILURES_BEFORE_RESOTRATION = 10;
 
-class Reluplex;
+// The default tableau storage engine. Build with COMPRESSED_TABLEAU defined to use compressed rows.
+#ifdef COMPRESSED_TABLEAU
+static const Tableau::StorageType DEFAULT_TABLEAU_STORAGE = Tableau::COMPRESSED_ROWS;
+#else
+static const Tableau::StorageType DEFAULT_TABLEAU_STORAGE = Tableau::LINKED_LISTS;
+#endif
+
+// Threads used for eliminating the entering column during a pivot (compressed tableau only).
+// Build with PIVOT_THREADS=<n> to change the default.
+#ifdef PIVOT_THREADS
+static const unsigned DEFAULT_PIVOT_THREADS = PIVOT_THREADS;
+#else
+static const unsigned DEFAULT_PIVOT_THREADS = 1;
+#endif
+
+// Threads used for evaluating rows in tightenAllBounds(). Build with TIGHTENING_THREADS=<n>
+// to change the default.
+#ifdef TIGHTENING_THREADS
+static const unsigned DEFAULT_TIGHTENING_THREADS = TIGHTENING_THREADS;
+#else
+static const unsigned DEFAULT_TIGHTENING_THREADS = 1;
+#endif
+
+// Whether the bounds of the network's neurons are recomputed symbolically after every split,
+// merge and pop (see setSymbolicBoundTightener()). Build with SYMBOLIC_BOUND_TIGHTENING=1 to
+// turn it on by default.
+#ifdef SYMBOLIC_BOUND_TIGHTENING
+static const bool DEFAULT_SYMBOLIC_BOUND_TIGHTENING = SYMBOLIC_BOUND_TIGHTENING;
+#else
+static const bool DEFAULT_SYMBOLIC_BOUND_TIGHTENING = false;
+#endif
+
+// Threads used for optimizing the bounds of the network's neurons with LPs before solving
+// (see setLpBoundTightening()). 0 turns this off. Build with LP_TIGHTENING_THREADS=<n> to
+// change the default.
+#ifdef LP_TIGHTENING_THREADS
+static const unsigned DEFAULT_LP_TIGHTENING_THREADS = LP_TIGHTENING_THREADS;
+#else
+static const unsigned DEFAULT_LP_TIGHTENING_THREADS = 0;
+#endif
+
+// The number of active ReLU pairs whose phases are probed before every split (see
+// probeReluPhases()). 0 turns probing off. Build with RELU_PROBING=<n> to change the default.
+#ifdef RELU_PROBING
+static const unsigned DEFAULT_RELU_PROBING_PAIRS = RELU_PROBING;
+#else
+static const unsigned DEFAULT_RELU_PROBING_PAIRS = 0;
+#endif
+
+// The number of rows a single probe may visit
+static const unsigned RELU_PROBING_MAX_ROW_VISITS = 500;
+
+// Columns with fewer entries than this are eliminated by the calling thread alone
+static const unsigned PARALLEL_PIVOT_COLUMN_THRESHOLD = 64;
+
+// The number of rows that the tightening threads check ahead of the calling thread when
+// bounds are propagated in parallel (see parallelPropagateBounds()).
+static const unsigned PARALLEL_TIGHTENING_BATCH_SIZE = 256;
+
+// The tableau is refactorized (rebuilt from the preprocessed tableau) once its number of
+// entries, or its largest entry, grows by more than these factors since the last time it
+// was rebuilt. 0 means no limit.
+static const double DEFAULT_MAX_FILL_IN_GROWTH = 0;
+static const double DEFAULT_MAX_ENTRY_GROWTH = 0;
 
-static Reluplex *activeReluplex;
+// Limits on bound propagation in tightenAllBounds(): the number of rows visited per call,
+// and how much a bound must improve before the rows it appears in are revisited. 0 means
+// no limit, and revisiting after any improvement. Propagating to a fixpoint costs far more
+// than it learns on the ACAS Xu networks, so by default a call visits about one and a half
+// times the rows of their tableaus.
+static const unsigned DEFAULT_BOUND_PROPAGATION_MAX_ROW_VISITS = 500;
+static const double DEFAULT_BOUND_PROPAGATION_MIN_IMPROVEMENT = 0;
 
-// Callbacks from GLPK
-void boundCalculationHook( int n, int m, int *head, int leavingBasic, int enteringNonBasic, double *basicRow );
-void iterationCountCallback( int count );
-void reportSoiCallback( double soi );
-int makeReluAdjustmentsCallback( int n, int m, int nonBasicEncoding, const int *head, const char *flags );
+// Callbacks from GLPK. The info is the Reluplex whose LP is being solved.
+void boundCalculationHook( void *info, int n, int m, int *head, int leavingBasic, int enteringNonBasic, double *basicRow );
+void iterationCountCallback( void *info, int count );
+void reportSoiCallback( void *info, double soi );
+int makeReluAdjustmentsCallback( void *info, int n, int m, int nonBasicEncoding, const int *head, const char *flags );
 
 class InvariantViolationError
 {
 public:
     InvariantViolationError( unsigned violatingStackLevel )
         : _violatingStackLevel( violatingStackLevel )
+        , _violatingDecisions( decisionsUpToLevel( violatingStackLevel ) )
+    {
+    }
+
+    InvariantViolationError( unsigned violatingStackLevel, DecisionSet violatingDecisions )
+        : _violatingStackLevel( violatingStackLevel )
+        , _violatingDecisions( violatingDecisions )
     {
     }
 
     unsigned _violatingStackLevel;
+
+    // The decisions that led to the violation
+    DecisionSet _violatingDecisions;
 };
 
 String milliToString( unsigned long long milliseconds )
@@ -73,6 +162,16 @@ String milliToString( unsigned long long milliseconds )
     return Stringf( "%02u:%02u:%02u", hours, minutes - hours * 60, seconds - ( minutes * 60 ) );
 }
 
+long peakResidentSetSizeKb()
+{
+    struct rusage usage;
+    if ( getrusage( RUSAGE_SELF, &usage ) != 0 )
+        return 0;
+
+    // On Linux, ru_maxrss is reported in kilobytes
+    return usage.ru_maxrss;
+}
+
 class Reluplex : public IReluplex
 {
 public:
@@ -95,25 +194,29 @@ public:
         }
     };
 
-    Reluplex( unsigned numVariables, char *finalOutputFile = NULL, String reluplexName = "" )
+    Reluplex( unsigned numVariables, char *finalOutputFile = NULL, String reluplexName = "",
+              Tableau::StorageType tableauStorage = DEFAULT_TABLEAU_STORAGE )
         : _numVariables( numVariables )
         , _reluplexName( reluplexName )
         , _finalOutputFile( finalOutputFile )
         , _finalStatus( NOT_DONE )
         , _wasInitialized( false )
-        , _tableau( numVariables )
-        , _preprocessedTableau( numVariables )
+        , _tableau( numVariables, tableauStorage )
+        , _preprocessedTableau( numVariables, tableauStorage )
         , _upperBounds( NULL )
         , _lowerBounds( NULL )
         , _preprocessedUpperBounds( NULL )
         , _preprocessedLowerBounds( NULL )
         , _assignment( NULL )
         , _preprocessedAssignment( NULL )
-        , _smtCore( this, _numVariables )
+        , _basicVariables( numVariables )
+        , _preprocessedBasicVariables( numVariables )
+        , _outOfBoundsBasics( numVariables )
+        , _brokenReluBs( numVariables )
+        , _smtCore( this, _numVariables, &_log )
         , _useApproximations( true )
         , _findAllPivotCandidates( false )
         , _conflictAnalysisCausedPop( 0 )
-        , _logging( false )
         , _dumpStates( false )
         , _numCallsToProgress( 0 )
         , _numPivots( 0 )
@@ -142,8 +245,14 @@ public:
         , _numBoundsDerivedThroughGlpk( 0 )
         , _numBoundsDerivedThroughGlpkOnSlacks( 0 )
         , _totalTightenAllBoundsTime( 0 )
+        , _boundPropagationRowVisits( 0 )
+        , _boundPropagationBudgetExhausted( 0 )
         , _eliminateAlmostBrokenRelus( false )
+        , _varToStatus( NULL )
+        , _dissolvedReluVariables( numVariables )
+        , _preprocessedDissolvedRelus( numVariables )
         , _printAssignment( false )
+        , _printStatistics( true )
         , _numOutOfBoundFixes( 0 )
         , _numOutOfBoundFixesViaBland( 0 )
         , _useDegradationChecking( false )
@@ -158,6 +267,15 @@ public:
         , _maxLpSolverTimeMilli( 0 )
         , _numberOfRestorations( 0 )
         , _maxDegradation( 0.0 )
+        , _maxFillInGrowth( DEFAULT_MAX_FILL_IN_GROWTH )
+        , _maxEntryGrowth( DEFAULT_MAX_ENTRY_GROWTH )
+        , _factorizedTableauSize( 0 )
+        , _factorizedMaxEntry( 0.0 )
+        , _pivotsAtLastFillInCheck( 0 )
+        , _peakTableauSize( 0 )
+        , _peakFillInGrowth( 0.0 )
+        , _peakEntryGrowth( 0.0 )
+        , _numRefactorizations( 0 )
         , _totalProgressTimeMilli( 0 )
         , _timeTighteningGlpkBoundsMilli( 0 )
         , _currentGlpkWrapper( NULL )
@@ -178,14 +296,37 @@ public:
         , _temporarilyDontUseSlacks( false )
         , _quit( false )
         , _fullTightenAllBounds( true )
+        , _boundPropagationMaxRowVisits( DEFAULT_BOUND_PROPAGATION_MAX_ROW_VISITS )
+        , _boundPropagationMinImprovement( DEFAULT_BOUND_PROPAGATION_MIN_IMPROVEMENT )
+        , _queuedBoundPropagationRows( numVariables )
         , _glpkExtractJustBasics( true )
         , _totalTimeEvalutingGlpkRows( 0 )
         , _consecutiveGlpkFailureCount( 0 )
+        , _pivotThreadPool( NULL )
+        , _parallelPivotThreshold( PARALLEL_PIVOT_COLUMN_THRESHOLD )
+        , _tighteningThreadPool( NULL )
+        , _rowsThatTighten( numVariables )
+        , _variablesChangedInBatch( numVariables )
+        , _symbolicBoundTightener( NULL )
+        , _symbolicBoundTightening( DEFAULT_SYMBOLIC_BOUND_TIGHTENING )
+        , _symbolicBoundTighteningPending( false )
+        , _numSymbolicBoundTightenings( 0 )
+        , _symbolicBoundsLearned( 0 )
+        , _totalSymbolicBoundTighteningTime( 0 )
+        , _violatingDecisions( 0 )
+        , _conflictDecisions( 0 )
+        , _lpTighteningThreads( DEFAULT_LP_TIGHTENING_THREADS )
+        , _numLpBoundTighteningLps( 0 )
+        , _numLpBoundTighteningFailures( 0 )
+        , _lpBoundsLearned( 0 )
+        , _totalLpBoundTighteningTime( 0 )
+        , _reluProbingPairs( DEFAULT_RELU_PROBING_PAIRS )
+        , _numProbingRounds( 0 )
+        , _numProbes( 0 )
+        , _numPairsFixedByProbing( 0 )
+        , _numProbingConflicts( 0 )
+        , _totalProbingTime( 0 )
     {
-        activeReluplex = this;
-
-        srand( time( 0 ) );
-
         _upperBounds = new VariableBound[_numVariables];
         _lowerBounds = new VariableBound[_numVariables];
         _preprocessedUpperBounds = new VariableBound[_numVariables];
@@ -193,15 +334,25 @@ public:
 
         _assignment = new double[_numVariables];
         _preprocessedAssignment = new double[_numVariables];
+        _varToStatus = new VariableStatus[_numVariables];
 
         for ( unsigned i = 0; i < _numVariables; ++i )
         {
             _assignment[i] = 0.0;
             _preprocessedAssignment[i] = 0.0;
+            _varToStatus[i] = VariableStatus::BETWEEN;
         }
 
-        FloatUtils::printEpsion();
-        printf( "Almost-broken nuking marging: %.15lf\n", ALMOST_BROKEN_RELU_MARGIN );
+        setPivotThreads( DEFAULT_PIVOT_THREADS );
+        setTighteningThreads( DEFAULT_TIGHTENING_THREADS );
+
+        // The same for every instance, so only the first one prints them
+        static std::atomic<bool> printedSettings( false );
+        if ( !printedSettings.exchange( true ) )
+        {
+            FloatUtils::printEpsion();
+            printf( "Almost-broken nuking marging: %.15lf\n", ALMOST_BROKEN_RELU_MARGIN );
+        }
     }
 
     ~Reluplex()
@@ -246,6 +397,108 @@ public:
             delete[] _preprocessedAssignment;
             _preprocessedAssignment = NULL;
         }
+
+        if ( _varToStatus )
+        {
+            delete[] _varToStatus;
+            _varToStatus = NULL;
+        }
+
+        if ( _pivotThreadPool )
+        {
+            delete _pivotThreadPool;
+            _pivotThreadPool = NULL;
+        }
+
+        if ( _tighteningThreadPool )
+        {
+            delete _tighteningThreadPool;
+            _tighteningThreadPool = NULL;
+        }
+    }
+
+    // Eliminate large columns in parallel during pivots. Only used by the compressed tableau.
+    void setPivotThreads( unsigned numThreads, unsigned columnThreshold = PARALLEL_PIVOT_COLUMN_THRESHOLD )
+    {
+        if ( _pivotThreadPool )
+        {
+            delete _pivotThreadPool;
+            _pivotThreadPool = NULL;
+        }
+
+        if ( numThreads > 1 )
+            _pivotThreadPool = new ThreadPool( numThreads );
+
+        _parallelPivotThreshold = columnThreshold;
+    }
+
+    /*
+      The network behind the encoding, used for the layers of the ReLU pairs and for LP bound
+      tightening. If symbolic bound tightening is on, the bounds of its neurons are also
+      computed symbolically when Reluplex is initialized and again after every split, merge
+      and pop. The tightener is owned by the caller.
+    */
+    void setSymbolicBoundTightener( SymbolicBoundTightener *symbolicBoundTightener )
+    {
+        _symbolicBoundTightener = symbolicBoundTightener;
+    }
+
+    void toggleSymbolicBoundTightening( bool value )
+    {
+        _symbolicBoundTightening = value;
+    }
+
+    // Choose how the SmtCore picks the pair to split on
+    void setBranchingHeuristic( BranchingHeuristic::Type type )
+    {
+        _smtCore.setBranchingHeuristic( type );
+    }
+
+    // Restart the search every so many conflicts (see SmtCore::RestartPolicy)
+    void setRestartPolicy( SmtCore::RestartPolicy policy )
+    {
+        _smtCore.setRestartPolicy( policy );
+    }
+
+    // Learn nogoods over the ReLU phases from conflicts, and propagate them (see NogoodDatabase.h)
+    void toggleNogoodLearning( bool value )
+    {
+        _smtCore.toggleNogoodLearning( value );
+    }
+
+    // Probe the phases of up to maxPairs active pairs before every split. 0 turns this off.
+    void setReluPhaseProbing( unsigned maxPairs )
+    {
+        _reluProbingPairs = maxPairs;
+    }
+
+    /*
+      Minimize and maximize every neuron with an LP when Reluplex is initialized, after the
+      first symbolic bound tightening (if it is on), with numThreads threads. The network is taken from
+      the symbolic bound tightener, which must be set. 0 turns this off.
+    */
+    void setLpBoundTightening( unsigned numThreads )
+    {
+        _lpTighteningThreads = numThreads;
+    }
+
+    // Evaluate the rows of tightenAllBounds() in parallel. Only used with full tightening.
+    void setTighteningThreads( unsigned numThreads )
+    {
+        if ( _tighteningThreadPool )
+        {
+            delete _tighteningThreadPool;
+            _tighteningThreadPool = NULL;
+        }
+
+        _tighteningRows.clear();
+
+        if ( numThreads > 1 )
+        {
+            _tighteningThreadPool = new ThreadPool( numThreads );
+            for ( unsigned i = 0; i < numThreads; ++i )
+                _tighteningRows.append( Vector<unsigned>() );
+        }
     }
 
     void initialize()
@@ -254,6 +507,15 @@ public:
         {
             initialUpdate();
             makeAllBoundsFinite();
+            if ( _symbolicBoundTightener )
+            {
+                computeReluLayers();
+                if ( _symbolicBoundTightening )
+                    symbolicBoundTightening();
+                if ( _lpTighteningThreads > 0 )
+                    lpBoundTightening();
+            }
+            fixStableRelus();
             _wasInitialized = true;
         }
         catch ( const InvariantViolationError &e )
@@ -292,19 +554,28 @@ public:
 
             storePreprocessedMatrix();
 
-            printf( "Initialization steps over.\n" );
-            printStatistics();
+            if ( _printStatistics )
+            {
+                printf( "Initialization steps over.\n" );
+                printStatistics();
+            }
             dump();
-            printf( "Starting the main loop\n" );
+            if ( _printStatistics )
+                printf( "Starting the main loop\n" );
+
+            // From here on, variable statuses are kept up to date as variables change
+            computeVariableStatus();
 
             while ( !_quit )
             {
-                computeVariableStatus();
+                DEBUG( checkOutOfBoundsBasics(); );
+                DEBUG( checkBrokenReluPairs(); );
 
                 if ( allVarsWithinBounds() && allRelusHold() )
                 {
                     dump();
-                    printStatistics();
+                    if ( _printStatistics )
+                        printStatistics();
                     _finalStatus = Reluplex::SAT;
                     end = Time::sampleMicro();
                     _totalProgressTimeMilli += Time::timePassed( start, end );
@@ -314,12 +585,19 @@ public:
                 unsigned violatingLevelInStack;
                 if ( !progress( violatingLevelInStack ) )
                 {
+                    _smtCore.learnNogood( _conflictDecisions );
+
                     if ( _useConflictAnalysis )
                         _smtCore.pop( violatingLevelInStack );
                     else
                         _smtCore.pop();
 
                     setMinStackSecondPhase( _currentStackDepth );
+                    _symbolicBoundTighteningPending = true;
+
+                    _smtCore.notifyConflict();
+                    if ( _smtCore.restartDue() )
+                        _smtCore.restart();
                 }
             }
         }
@@ -365,7 +643,7 @@ public:
 
     bool progress( unsigned &violatingLevelInStack )
     {
-        log( "Progress starting\n" );
+        SOLVER_LOG( _log, LOG_SEARCH, LOG_DEBUG, "Progress starting\n" );
 
         try
         {
@@ -373,6 +651,7 @@ public:
 
             // The default
             violatingLevelInStack = _currentStackDepth;
+            _conflictDecisions = decisionsUpToLevel( _currentStackDepth );
 
             if ( _useDegradationChecking && ( _numCallsToProgress % 50 == 0 ) )
             {
@@ -384,7 +663,14 @@ public:
                 }
             }
 
-            if ( _numCallsToProgress % PRINT_STATISTICS == 0 )
+            if ( fillInLimitExceeded() )
+            {
+                ++_numRefactorizations;
+                restoreTableauFromBackup();
+                return true;
+            }
+
+            if ( _printStatistics && _numCallsToProgress % PRINT_STATISTICS == 0 )
                 printStatistics();
 
             if ( _printAssignment && _numCallsToProgress % PRINT_ASSIGNMENT == 0 )
@@ -392,13 +678,24 @@ public:
 
             dump();
 
-            List<unsigned> outOfBoundVariables;
-            findOutOfBounds( outOfBoundVariables );
+            // Phases fixed since the last step may make learned nogoods unit
+            unsigned numNogoodPropagations = _smtCore.getNumNogoodPropagations();
+            if ( !_smtCore.propagateNogoods() )
+                throw InvariantViolationError( _currentStackDepth );
+            if ( _smtCore.getNumNogoodPropagations() > numNogoodPropagations )
+                _symbolicBoundTighteningPending = true;
+
+            // The previous step was a split, a merge or a pop: recompute the symbolic bounds
+            if ( _symbolicBoundTighteningPending && _symbolicBoundTightener && _symbolicBoundTightening )
+            {
+                _symbolicBoundTighteningPending = false;
+                symbolicBoundTightening();
+            }
 
             // If we have out-of-bounds variables, we deal with them first
-            if ( !outOfBoundVariables.empty() )
+            if ( !_outOfBoundsBasics.empty() )
             {
-                log( "Progress: have OOB vars\n" );
+                SOLVER_LOG( _log, LOG_SEARCH, LOG_DEBUG, "Progress: have OOB vars\n" );
 
                 GlpkWrapper::GlpkAnswer answer = fixOutOfBounds();
 
@@ -456,30 +753,31 @@ public:
             _consecutiveGlpkFailureCount = 0;
             _previousGlpkAnswer = GlpkWrapper::SOLUTION_FOUND;
 
-            log( "No OOB variables to fix, looking at broken relus\n" );
+            SOLVER_LOG( _log, LOG_SEARCH, LOG_DEBUG, "No OOB variables to fix, looking at broken relus\n" );
 
             // If we got here, either there are no OOB variables, or they were fixed without changing the tableau
             // and we still have broken relus. Split on one of them.
-            List<unsigned> brokenRelus;
-            findBrokenRelues( brokenRelus );
-            _totalNumBrokenRelues += brokenRelus.size();
+            _totalNumBrokenRelues += 2 * _brokenReluBs.size();
 
-            unsigned brokenReluVar = *brokenRelus.begin();
-            unsigned f = _reluPairs.isF( brokenReluVar ) ? brokenReluVar : _reluPairs.toPartner( brokenReluVar );
+            unsigned f = _reluPairs.bToF( lowestBrokenReluB() );
 
             if ( _smtCore.notifyBrokenRelu( f ) )
+            {
+                _symbolicBoundTighteningPending = true;
                 return true; // Splitting/Merging is a form of progress
+            }
             return fixBrokenRelu( f );
         }
 
         catch ( const InvariantViolationError &e )
         {
-            log( "\n\n*** Upper/lower invariant violated! Failure ***\n\n" );
+            SOLVER_LOG( _log, LOG_SEARCH, LOG_DEBUG, "\n\n*** Upper/lower invariant violated! Failure ***\n\n" );
 
             if ( e._violatingStackLevel != _currentStackDepth )
             {
                 violatingLevelInStack = e._violatingStackLevel;
             }
+            _conflictDecisions = e._violatingDecisions;
 
             return false;
         }
@@ -490,11 +788,25 @@ public:
         _useDegradationChecking = value;
     }
 
+    // Limits on the growth of the tableau between refactorizations. 0 means no limit.
+    void setRefactorizationLimits( double maxFillInGrowth, double maxEntryGrowth )
+    {
+        _maxFillInGrowth = maxFillInGrowth;
+        _maxEntryGrowth = maxEntryGrowth;
+    }
+
     void toggleFullTightenAllBounds( bool value )
     {
         _fullTightenAllBounds = value;
     }
 
+    // Limits on bound propagation in tightenAllBounds(). 0 means no limit.
+    void setBoundPropagationBudget( unsigned maxRowVisits, double minImprovement )
+    {
+        _boundPropagationMaxRowVisits = maxRowVisits;
+        _boundPropagationMinImprovement = minImprovement;
+    }
+
     void toggleGlpkExtractJustBasics( bool value )
     {
         _glpkExtractJustBasics = value;
@@ -505,6 +817,12 @@ public:
         _printAssignment = value;
     }
 
+    // Statistics printed while solving. The final statistics are not affected.
+    void togglePrintStatistics( bool value )
+    {
+        _printStatistics = value;
+    }
+
     void toggleAlmostBrokenReluEliminiation( bool value )
     {
         if ( value )
@@ -516,38 +834,50 @@ public:
     bool allVarsWithinBounds( bool print = false ) const
     {
         // Only basic variables can be out-of-bounds
-        for ( auto i : _basicVariables )
-            if ( outOfBounds( i ) )
-            {
-                if ( print )
-                {
-                    printf( "Variable %u out of bounds: value = %.10lf, range = [%.10lf, %.10lf]\n",
-                        i,
-                        _assignment[i],
-                        _lowerBounds[i].getBound(),
-                        _upperBounds[i].getBound() );
-                }
-
-                return false;
-            }
+        if ( _outOfBoundsBasics.empty() )
+            return true;
 
+        if ( print )
+        {
+            unsigned i = _outOfBoundsBasics.pick();
+            printf( "Variable %u out of bounds: value = %.10lf, range = [%.10lf, %.10lf]\n",
+                    i,
+                    _assignment[i],
+                    _lowerBounds[i].getBound(),
+                    _upperBounds[i].getBound() );
+        }
 
-        return true;
+        return false;
     }
 
     bool allRelusHold() const
     {
-        const Set<ReluPairs::ReluPair> &pairs( _reluPairs.getPairs() );
-        for ( const auto &pair : pairs )
-        {
-            unsigned b = pair.getB();
-            unsigned f = pair.getF();
+        return _brokenReluBs.empty();
+    }
 
-            if ( ( !_dissolvedReluVariables.exists( f ) ) && reluPairIsBroken( b, f ) )
-                return false;
+    const SparseIndexSet &getBrokenReluBs() const
+    {
+        return _brokenReluBs;
+    }
+
+    // The pair to split on is the broken one with the lowest b, which favors the earlier
+    // layers. Only the broken pairs are looked at, not all of them.
+    unsigned lowestBrokenReluB() const
+    {
+        unsigned lowest = _brokenReluBs.pick();
+        for ( unsigned b : _brokenReluBs )
+        {
+            if ( b < lowest )
+                lowest = b;
         }
 
-        return true;
+        return lowest;
+    }
+
+    // The layer of a ReLU pair, as given by the symbolic bound tightener. 0 if unknown.
+    unsigned getReluLayer( unsigned f ) const
+    {
+        return _reluLayers.exists( f ) ? _reluLayers.get( f ) : 0;
     }
 
     bool reluPairIsBroken( unsigned b, unsigned f ) const
@@ -609,7 +939,7 @@ public:
 
     VariableStatus getVarStatus( unsigned variable ) const
     {
-        return _varToStatus.at( variable );
+        return _varToStatus[variable];
     }
 
     bool reluPairAlmostBroken( unsigned b, unsigned f ) const
@@ -634,46 +964,87 @@ public:
         return false;
     }
 
-    void findOutOfBounds( List<unsigned> &result ) const
+    // Keep the set of out-of-bounds basic variables in sync with the variable's status
+    void updateOutOfBoundsBasics( unsigned variable )
+    {
+        if ( _basicVariables.exists( variable ) && outOfBounds( variable ) )
+            _outOfBoundsBasics.insert( variable );
+        else
+            _outOfBoundsBasics.erase( variable );
+    }
+
+    void checkOutOfBoundsBasics() const
     {
-        // Only basic variables can be out-of-bounds
         for ( auto i : _basicVariables )
-            if ( outOfBounds( i ) )
-                result.append( i );
+        {
+            if ( outOfBounds( i ) != _outOfBoundsBasics.exists( i ) )
+            {
+                printf( "Error! Out-of-bounds basic variable %s is not tracked correctly\n",
+                        toName( i ).ascii() );
+                exit( 1 );
+            }
+        }
+
+        for ( auto i : _outOfBoundsBasics )
+        {
+            if ( !_basicVariables.exists( i ) )
+            {
+                printf( "Error! Non-basic variable %s is tracked as out-of-bounds\n", toName( i ).ascii() );
+                exit( 1 );
+            }
+        }
     }
 
     void countBrokenReluPairs( unsigned &brokenReluPairs, unsigned &brokenNonBasicReluPairs ) const
     {
-        brokenReluPairs = 0;
+        brokenReluPairs = _brokenReluBs.size();
         brokenNonBasicReluPairs = 0;
 
-        const Set<ReluPairs::ReluPair> &pairs( _reluPairs.getPairs() );
-        for ( const auto &pair : pairs )
+        for ( auto b : _brokenReluBs )
         {
-            unsigned b = pair.getB();
-            unsigned f = pair.getF();
-
-            if ( ( !_dissolvedReluVariables.exists( f ) ) && reluPairIsBroken( b, f ) )
-            {
-                ++brokenReluPairs;
-                if ( !_basicVariables.exists( b ) && !_basicVariables.exists( f ) )
-                    ++brokenNonBasicReluPairs;
-            }
+            unsigned f = _reluPairs.bToF( b );
+            if ( !_basicVariables.exists( b ) && !_basicVariables.exists( f ) )
+                ++brokenNonBasicReluPairs;
         }
     }
 
     void findBrokenRelues( List<unsigned> &result ) const
     {
-        const Set<ReluPairs::ReluPair> &pairs( _reluPairs.getPairs() );
-        for ( const auto &pair : pairs )
+        for ( auto b : _brokenReluBs )
+        {
+            result.append( b );
+            result.append( _reluPairs.bToF( b ) );
+        }
+    }
+
+    // Keep the set of broken pairs in sync with the assignment of one of the pair's variables
+    void updateBrokenReluPairs( unsigned variable )
+    {
+        if ( !_reluPairs.isRelu( variable ) )
+            return;
+
+        unsigned b = _reluPairs.isB( variable ) ? variable : _reluPairs.fToB( variable );
+        unsigned f = _reluPairs.bToF( b );
+
+        if ( ( !_dissolvedReluVariables.exists( f ) ) && reluPairIsBroken( b, f ) )
+            _brokenReluBs.insert( b );
+        else
+            _brokenReluBs.erase( b );
+    }
+
+    void checkBrokenReluPairs() const
+    {
+        for ( const auto &pair : _reluPairs.getPairs() )
         {
             unsigned b = pair.getB();
             unsigned f = pair.getF();
 
-            if ( ( !_dissolvedReluVariables.exists( f ) ) && reluPairIsBroken( b, f ) )
+            bool broken = ( !_dissolvedReluVariables.exists( f ) ) && reluPairIsBroken( b, f );
+            if ( broken != _brokenReluBs.exists( b ) )
             {
-                result.append( b );
-                result.append( f );
+                printf( "Error! Broken relu pair <%s, %s> is not tracked correctly\n",
+                        toName( b ).ascii(), toName( f ).ascii() );
+                exit( 1 );
             }
         }
     }
@@ -767,10 +1138,16 @@ public:
             // Both bounds infinite
             _varToStatus[i] = VariableStatus::BETWEEN;
         }
+
+        updateOutOfBoundsBasics( i );
+        updateBrokenReluPairs( i );
     }
 
     void printStatistics()
     {
+        // Keep the log and the statistics in order
+        _log.flush();
+
         countVarsWithInfiniteBounds();
 
         printf( "\n" );
@@ -785,6 +1162,12 @@ public:
                 _totalPivotCalculationCount > 0 ? ((double)_totalPivotTimeMilli) / _totalPivotCalculationCount : 0 );
         printf( "\tAverage number of calculations in pivot: %llu\n",
                 _numPivots > 0 ? _totalPivotCalculationCount / _numPivots : 0 );
+        printf( "\tTableau storage: %s. Entries: %u. Dense rows: %u. Rows copied on write: %llu. Peak RSS: %ld KB\n",
+                Tableau::storageTypeToString( _tableau.getStorageType() ),
+                _tableau.totalSize(),
+                _tableau.countDenseRows(),
+                _tableau.getNumRowCopies(),
+                peakResidentSetSizeKb() );
         printf( "\tAverage number of broken relues per 'progress': %llu\n",
                 _numCallsToProgress > 0 ? _totalNumBrokenRelues / _numCallsToProgress : 0 );
         printf( "\tBroken Relus Fixed: %u (Fs: %u, Bs: %u, fix-by-pivot: %u, fix-by-update: %u)\n",
@@ -797,8 +1180,25 @@ public:
         printf( "\tAlmost broken relus encountered: %u. Nuked: %u\n",
                 _almostBrokenReluPairCount, _almostBrokenReluPairFixedCount );
 
-        printf( "\tTime in TightenAllBounds: %llu milli. Bounds tightened: %llu\n",
-                _totalTightenAllBoundsTime, _boundsTightendByTightenAllBounds );
+        printf( "\tTime in TightenAllBounds: %llu milli. Bounds tightened: %llu. Rows visited: %llu "
+                "(budget exhausted %u times)\n",
+                _totalTightenAllBoundsTime, _boundsTightendByTightenAllBounds,
+                _boundPropagationRowVisits, _boundPropagationBudgetExhausted );
+
+        if ( _symbolicBoundTightener && _symbolicBoundTightening )
+            printf( "\tSymbolic bound tightening: %u runs, %llu milli. Bounds tightened: %llu\n",
+                    _numSymbolicBoundTightenings, _totalSymbolicBoundTighteningTime, _symbolicBoundsLearned );
+
+        if ( _symbolicBoundTightener && _lpTighteningThreads > 0 )
+            printf( "\tLP bound tightening: %u LPs (%u failed) on %u threads, %llu milli. Bounds tightened: %llu\n",
+                    _numLpBoundTighteningLps, _numLpBoundTighteningFailures, _lpTighteningThreads,
+                    _totalLpBoundTighteningTime, _lpBoundsLearned );
+
+        if ( _reluProbingPairs > 0 )
+            printf( "\tReLU phase probing: %u rounds, %llu probes, %llu milli. "
+                    "Pairs fixed: %u. Conflicts: %u\n",
+                    _numProbingRounds, _numProbes, _totalProbingTime,
+                    _numPairsFixedByProbing, _numProbingConflicts );
 
         printf( "\tRelu pairs dissolved: %u. Num splits: %u. Num merges: %u (remaining: %u / %u)\n",
                 _dissolvedReluVariables.size(),
@@ -855,6 +1255,16 @@ public:
                 _numStackSplits, _numStackMerges, _numStackPops, _numStackVisitedStates );
         printf( "\t\tPops caused by conflict analysis: %u\n", _conflictAnalysisCausedPop );
         printf( "\t\tTotal time in smtCore: %llu milli\n", _smtCore.getSmtCoreTime() );
+        printf( "\t\tBranching heuristic: %s. Splits on a pair other than the one that reached the limit: %u\n",
+                _smtCore.getBranchingHeuristic()->getName(), _smtCore.getNumHeuristicChoices() );
+        if ( _smtCore.getNogoodLearning() )
+            printf( "\t\tNogoods learned: %u (%u too long to keep). Phases forced: %u. Conflicts: %u\n",
+                    _smtCore.getNumNogoodsLearned(), _smtCore.getNumNogoodsDropped(),
+                    _smtCore.getNumNogoodPropagations(), _smtCore.getNumNogoodConflicts() );
+        if ( _smtCore.getRestartPolicy() != SmtCore::NO_RESTARTS )
+            printf( "\t\tRestarts (%s): %u. Level 0 bounds kept across restarts: %u\n",
+                    _smtCore.getRestartPolicyName(), _smtCore.getNumRestarts(),
+                    _smtCore.getNumLevelZeroBoundsKept() );
         printf( "\tCurrent degradation: %.10lf. Time spent checking: %llu milli. Max measured: %.10lf.\n",
                 checkDegradation(), _totalDegradationCheckingTimeMilli, _maxDegradation );
         printf( "\tNumber of restorations: %u. Total time: %llu milli. Average: %lf\n",
@@ -862,6 +1272,10 @@ public:
                 _totalRestorationTimeMilli,
                 percents( _totalRestorationTimeMilli, _numberOfRestorations )
                 );
+        printf( "\tFill-in: %u entries (peak: %u, %u after last refactorization). "
+                "Peak growth: entries x%.2lf, largest entry x%.2lf. Refactorizations: %u\n",
+                _tableau.totalSize(), _peakTableauSize, _factorizedTableauSize,
+                _peakFillInGrowth, _peakEntryGrowth, _numRefactorizations );
 
         unsigned long long totalUnaccountedFor =
             _totalProgressTimeMilli -
@@ -992,7 +1406,7 @@ public:
         ++_numLpSolverInvocations;
 
         timeval lpStart = Time::sampleMicro();
-        GlpkWrapper glpkWrapper;
+        GlpkWrapper glpkWrapper( &_log );
         _currentGlpkWrapper = &glpkWrapper;
         _glpkStoredLowerBounds.clear();
         _glpkStoredUpperBounds.clear();
@@ -1003,7 +1417,7 @@ public:
         {
             if ( _temporarilyDontUseSlacks )
             {
-                log( "Temporarily disabling slacks\n" );
+                SOLVER_LOG( _log, LOG_GLPK, LOG_DEBUG, "Temporarily disabling slacks\n" );
                 _temporarilyDontUseSlacks = false;
             }
             else
@@ -1012,6 +1426,7 @@ public:
 
         _reluUpdateFrequency.clear();
 
+        glpkWrapper.setCallbackInfo( this );
         glpkWrapper.setBoundCalculationHook( &boundCalculationHook );
         glpkWrapper.setIterationCountCallback( &iterationCountCallback );
         glpkWrapper.setReportSoiCallback( &reportSoiCallback );
@@ -1045,7 +1460,7 @@ public:
 
         if ( answer == GlpkWrapper::SOLUTION_FOUND )
         {
-            log( "LP solver solved the problem. Updating tableau and assignment\n" );
+            SOLVER_LOG( _log, LOG_GLPK, LOG_DEBUG, "LP solver solved the problem. Updating tableau and assignment\n" );
             ++_numLpSolverFoundSolution;
 
             timeval extractionStart = Time::sampleMicro();
@@ -1053,11 +1468,11 @@ public:
             // Two options: either restore by basics (and pivot manually), or just take the entire tableau.
             if ( _glpkExtractJustBasics )
             {
-                Set<unsigned> newBasics;
+                IndexSet newBasics( _numVariables );
                 glpkWrapper.extractBasicVariables( *this, newBasics );
 
-                Set<unsigned> shouldBeBasic = Set<unsigned>::difference( newBasics, _basicVariables );
-                Set<unsigned> shouldntBeBasic = Set<unsigned>::difference( _basicVariables, newBasics );
+                IndexSet shouldBeBasic = IndexSet::difference( newBasics, _basicVariables );
+                IndexSet shouldntBeBasic = IndexSet::difference( _basicVariables, newBasics );
                 adjustBasicVariables( shouldBeBasic, shouldntBeBasic, false );
             }
             else
@@ -1097,7 +1512,7 @@ public:
             {
                 // This rarely happens, but when it does - need to restore.
                 // I'm guessing this is due to numerical instability when restoring the basics.
-                log( "Error! Returned from GLPK but have oob variables\n" );
+                SOLVER_LOG( _log, LOG_GLPK, LOG_DEBUG, "Error! Returned from GLPK but have oob variables\n" );
 
                 ++_numLpSolverIncorrectAssignment;
                 restoreTableauFromBackup( _consecutiveGlpkFailureCount < 5 );
@@ -1122,14 +1537,14 @@ public:
         }
         else if ( answer == GlpkWrapper::NO_SOLUTION_EXISTS )
         {
-            log( "LP solver showed no solution exists\n" );
+            SOLVER_LOG( _log, LOG_GLPK, LOG_DEBUG, "LP solver showed no solution exists\n" );
             ++_numLpSolverNoSolution;
             _previousGlpkAnswer = GlpkWrapper::NO_SOLUTION_EXISTS;
             _consecutiveGlpkFailureCount = 0;
             return GlpkWrapper::NO_SOLUTION_EXISTS;
         }
 
-        log( "LP solver failed! Restoring from original matrix...\n" );
+        SOLVER_LOG( _log, LOG_GLPK, LOG_DEBUG, "LP solver failed! Restoring from original matrix...\n" );
         ++_numLpSolverFailed;
         restoreTableauFromBackup( _consecutiveGlpkFailureCount < 5 );
 
@@ -1483,7 +1898,7 @@ public:
 
     void performGlpkBoundTightening()
     {
-        log( "Starting GLPK bound tightening\n" );
+        SOLVER_LOG( _log, LOG_BOUNDS, LOG_DEBUG, "Starting GLPK bound tightening\n" );
 
         // It is wrong to assume that all bounds are improvements over existing bounds. As
         // we begin updating, things may change because of relu stuff - so check again before
@@ -1503,29 +1918,31 @@ public:
         _glpkStoredLowerBounds.clear();
         _glpkStoredUpperBounds.clear();
 
-        log( "Finished with GLPK bound tightening\n" );
+        SOLVER_LOG( _log, LOG_BOUNDS, LOG_DEBUG, "Finished with GLPK bound tightening\n" );
     }
 
     void glpkIterationCountCallback( int count )
     {
-        log( Stringf( "GLPK: number of iterations = %i\n", count ) );
+        SOLVER_LOG( _log, LOG_GLPK, LOG_TRACE, "GLPK: number of iterations = %i\n", count );
         _totalLpPivots += count;
     }
 
     void glpkReportSoi( double soi )
     {
-        log( Stringf( "GLPK report soi: %.10lf\n", soi ) );
+        SOLVER_LOG( _log, LOG_GLPK, LOG_TRACE, "GLPK report soi: %.10lf\n", soi );
         _glpkSoi = soi;
     }
 
     void setUpperBound( unsigned variable, double bound )
     {
+        trailUpperBound( variable );
         _upperBounds[variable].setBound( bound );
         _upperBounds[variable].setLevel( 0 );
     }
 
     void setLowerBound( unsigned variable, double bound )
     {
+        trailLowerBound( variable );
         _lowerBounds[variable].setBound( bound );
         _lowerBounds[variable].setLevel( 0 );
     }
@@ -1538,6 +1955,7 @@ public:
         if ( !FloatUtils::lte( _lowerBounds[variable].getBound(), _upperBounds[variable].getBound() ) )
         {
             violatingStackLevel = std::max( _lowerBounds[variable].getLevel(), _upperBounds[variable].getLevel() );
+            _violatingDecisions = _lowerBounds[variable].getDecisions() | _upperBounds[variable].getDecisions();
             return false;
         }
 
@@ -1554,6 +1972,12 @@ public:
     }
 
     void updateUpperBound( unsigned variable, double bound, unsigned level )
+    {
+        updateUpperBound( variable, bound, level, decisionsUpToLevel( level ) );
+    }
+
+    // Update an upper bound that is known to depend only on the given decisions
+    void updateUpperBound( unsigned variable, double bound, unsigned level, DecisionSet decisions )
     {
         unsigned partner = 0, b = 0, f = 0;
 
@@ -1568,12 +1992,13 @@ public:
         if ( !_reluPairs.isRelu( variable ) || _dissolvedReluVariables.exists( f ) )
         {
             // For non-relus, we can just update the bound.
+            trailUpperBound( variable );
             _upperBounds[variable].setBound( bound );
-            _upperBounds[variable].setLevel( level );
+            _upperBounds[variable].setLevel( level, decisions );
 
             unsigned violatingStackLevel;
             if ( !boundInvariantHolds( variable, violatingStackLevel ) )
-                throw InvariantViolationError( violatingStackLevel );
+                throw InvariantViolationError( violatingStackLevel, _violatingDecisions );
 
             computeVariableStatus( variable );
 
@@ -1601,15 +2026,17 @@ public:
         // If the bound is positive, update bounds on both F and B.
         if ( FloatUtils::isPositive( bound ) )
         {
+            trailUpperBound( variable );
             _upperBounds[variable].setBound( bound );
-            _upperBounds[variable].setLevel( level );
+            _upperBounds[variable].setLevel( level, decisions );
+            trailUpperBound( partner );
             _upperBounds[partner].setBound( bound );
-            _upperBounds[partner].setLevel( level );
+            _upperBounds[partner].setLevel( level, decisions );
 
             unsigned violatingStackLevel;
             if ( !boundInvariantHolds( variable, violatingStackLevel ) ||
                  !boundInvariantHolds( partner, violatingStackLevel ) )
-                throw InvariantViolationError( violatingStackLevel );
+                throw InvariantViolationError( violatingStackLevel, _violatingDecisions );
 
             computeVariableStatus( variable );
             computeVariableStatus( partner );
@@ -1627,13 +2054,14 @@ public:
             // Non-positive bound.
             if ( FloatUtils::isNegative( bound ) && _reluPairs.isF( variable ) )
             {
+                trailUpperBound( variable );
                 _upperBounds[variable].setBound( bound );
-                _upperBounds[variable].setLevel( level );
+                _upperBounds[variable].setLevel( level, decisions );
 
                 // F variables have lower bound of at least 0. Do this "by-the-book" for proper stack handling.
                 unsigned violatingStackLevel;
                 if ( !boundInvariantHolds( variable, violatingStackLevel ) )
-                    throw InvariantViolationError( violatingStackLevel );
+                    throw InvariantViolationError( violatingStackLevel, _violatingDecisions );
                 else
                 {
                     printf( "Error! Expected violation on F!\n" );
@@ -1644,14 +2072,17 @@ public:
             // F will have zero as upper bound.
             markReluVariableDissolved( f, TYPE_SPLIT );
 
+            trailUpperBound( f );
+
             _upperBounds[f].setBound( 0.0 );
-            _upperBounds[f].setLevel( level );
+            _upperBounds[f].setLevel( level, decisions );
+            trailUpperBound( b );
             _upperBounds[b].setBound( bound );
-            _upperBounds[b].setLevel( level );
+            _upperBounds[b].setLevel( level, decisions );
 
             unsigned violatingStackLevel;
             if ( !boundInvariantHolds( b, violatingStackLevel ) || !boundInvariantHolds( f, violatingStackLevel ) )
-                throw InvariantViolationError( violatingStackLevel );
+                throw InvariantViolationError( violatingStackLevel, _violatingDecisions );
 
             computeVariableStatus( b );
             computeVariableStatus( f );
@@ -1667,6 +2098,11 @@ public:
     }
 
     bool updateLowerBound( unsigned variable, double bound, unsigned level )
+    {
+        return updateLowerBound( variable, bound, level, decisionsUpToLevel( level ) );
+    }
+
+    bool updateLowerBound( unsigned variable, double bound, unsigned level, DecisionSet decisions )
     {
         unsigned partner = 0, b = 0, f = 0;
 
@@ -1681,12 +2117,13 @@ public:
         if ( !_reluPairs.isRelu( variable ) || _dissolvedReluVariables.exists( f ) )
         {
             // For non-relus, we can just update the bound.
+            trailLowerBound( variable );
             _lowerBounds[variable].setBound( bound );
-            _lowerBounds[variable].setLevel( level );
+            _lowerBounds[variable].setLevel( level, decisions );
 
             unsigned violatingStackLevel;
             if ( !boundInvariantHolds( variable, violatingStackLevel ) )
-                throw InvariantViolationError( violatingStackLevel );
+                throw InvariantViolationError( violatingStackLevel, _violatingDecisions );
 
             computeVariableStatus( variable );
 
@@ -1715,17 +2152,20 @@ public:
         // If the bound is non-negative, update bounds on both F and B.
         if ( !FloatUtils::isNegative( bound ) )
         {
-            log( "Update lower bound: non-negative lower bound\n" );
+            SOLVER_LOG( _log, LOG_BOUNDS, LOG_DEBUG, "Update lower bound: non-negative lower bound\n" );
+
+            trailLowerBound( variable );
 
             _lowerBounds[variable].setBound( bound );
-            _lowerBounds[variable].setLevel( level );
+            _lowerBounds[variable].setLevel( level, decisions );
+            trailLowerBound( partner );
             _lowerBounds[partner].setBound( bound );
-            _lowerBounds[partner].setLevel( level );
+            _lowerBounds[partner].setLevel( level, decisions );
 
             unsigned violatingStackLevel;
             if ( !boundInvariantHolds( variable, violatingStackLevel ) ||
                  !boundInvariantHolds( partner, violatingStackLevel ) )
-                throw InvariantViolationError( violatingStackLevel );
+                throw InvariantViolationError( violatingStackLevel, _violatingDecisions );
 
             computeVariableStatus( variable );
             computeVariableStatus( partner );
@@ -1742,12 +2182,14 @@ public:
         {
             // Negative bound. This can only be called for the B, doesn't affect the F.
 
+            trailLowerBound( variable );
+
             _lowerBounds[variable].setBound( bound );
-            _lowerBounds[variable].setLevel( level );
+            _lowerBounds[variable].setLevel( level, decisions );
 
             unsigned violatingStackLevel;
             if ( !boundInvariantHolds( variable, violatingStackLevel ) )
-                throw InvariantViolationError( violatingStackLevel );
+                throw InvariantViolationError( violatingStackLevel, _violatingDecisions );
 
             computeVariableStatus( variable );
 
@@ -1765,18 +2207,18 @@ public:
     bool unifyReluPair( unsigned f )
     {
         unsigned b = _reluPairs.toPartner( f );
-        log( Stringf( "UnifyReluPair called with f = %s, b = %s\n", toName( f ).ascii(),
-                      toName( b ).ascii()) );
+        SOLVER_LOG( _log, LOG_RELU, LOG_DEBUG, "UnifyReluPair called with f = %s, b = %s\n", toName( f ).ascii(),
+                    toName( b ).ascii() );
 
         // If these two have been unified before, b's column will be empty. Tableau doesn't change.
         if ( _tableau.getColumnSize( b ) == 0 )
         {
-            log( Stringf( "UnifyReluPair: b's column is empty, ignroing. Previous dissolved? %s\n",
-                          _dissolvedReluVariables.exists( f ) ? "YES" : "NO" ) );
+            SOLVER_LOG( _log, LOG_RELU, LOG_DEBUG, "UnifyReluPair: b's column is empty, ignroing. Previous dissolved? %s\n",
+                        _dissolvedReluVariables.exists( f ) ? "YES" : "NO" );
             return false;
         }
 
-        log( Stringf( "Unifying relu pair: %s, %s\n", toName( b ).ascii(), toName( f ).ascii() ) );
+        SOLVER_LOG( _log, LOG_RELU, LOG_DEBUG, "Unifying relu pair: %s, %s\n", toName( b ).ascii(), toName( f ).ascii() );
 
         // First step: make sure f and b are not basic.
         // Note: this may temporarily break the axiom that non-basic variables must be within bounds
@@ -1788,7 +2230,7 @@ public:
         if ( _basicVariables.exists( f ) )
             makeNonBasic( f, b );
 
-        log( "Both variables are now non-basic\n" );
+        SOLVER_LOG( _log, LOG_RELU, LOG_DEBUG, "Both variables are now non-basic\n" );
         dump();
 
         // Next: set f to be in bounds.
@@ -1805,7 +2247,7 @@ public:
 
         markReluVariableDissolved( f, TYPE_MERGE );
 
-        log( "Tableau after unification:\n" );
+        SOLVER_LOG( _log, LOG_RELU, LOG_DEBUG, "Tableau after unification:\n" );
         dump();
 
         return true;
@@ -1816,23 +2258,23 @@ public:
         if ( !_basicVariables.exists( basic ) )
             throw Error( Error::VARIABLE_NOT_BASIC );
 
-        const Tableau::Entry *rowEntry = _tableau.getRow( basic );
-        const Tableau::Entry *current;
+        Tableau::Iterator rowEntry = _tableau.getRow( basic );
+        Tableau::Iterator current;
 
         bool found = false;
         unsigned leastEvilNonBasic = 0;
         double leastEvilWeight = 0.0;
 
-        while ( rowEntry )
+        while ( !rowEntry.atEnd() )
         {
             current = rowEntry;
-            rowEntry = rowEntry->nextInRow();
+            rowEntry.advance();
 
-            unsigned column = current->getColumn();
+            unsigned column = current.getColumn();
             if ( ( column == basic ) || ( column == forbiddenPartner ) )
                 continue;
 
-            double weight = FloatUtils::abs( current->getValue() );
+            double weight = FloatUtils::abs( current.getValue() );
             if ( FloatUtils::gte( weight, NUMBERICAL_INSTABILITY_CONSTANT ) )
             {
                 pivot( column, basic );
@@ -1881,11 +2323,12 @@ public:
     void markBasic( unsigned variable )
     {
         _basicVariables.insert( variable );
+        updateOutOfBoundsBasics( variable );
     }
 
     void setName( unsigned variable, String name )
     {
-        log( Stringf( "Setting name: %s --> %u\n", name.ascii(), variable ) );
+        SOLVER_LOG( _log, LOG_SEARCH, LOG_DEBUG, "Setting name: %s --> %u\n", name.ascii(), variable );
         _variableNames[variable] = name;
     }
 
@@ -1920,7 +2363,7 @@ public:
             }
         }
 
-        log( "Checking invariants after initial update\n" );
+        SOLVER_LOG( _log, LOG_SEARCH, LOG_DEBUG, "Checking invariants after initial update\n" );
         checkInvariants();
     }
 
@@ -1933,7 +2376,7 @@ public:
 
         ++_brokenRelusFixed;
 
-        log( Stringf( "\nAttempting broken-relu fix on var: %s\n", toName( toFix ).ascii() ) );
+        SOLVER_LOG( _log, LOG_RELU, LOG_DEBUG, "\nAttempting broken-relu fix on var: %s\n", toName( toFix ).ascii() );
 
         double fVal = _assignment[f];
         double bVal = _assignment[b];
@@ -1970,7 +2413,7 @@ public:
 
     bool fixBrokenReluVariable( unsigned var, bool increase, double &delta, unsigned &_brokenReluStat )
     {
-        log( Stringf( "fixBrokenReluVariable Starting: var = %s, delta = %lf\n", toName( var ).ascii(), delta ) );
+        SOLVER_LOG( _log, LOG_RELU, LOG_DEBUG, "fixBrokenReluVariable Starting: var = %s, delta = %lf\n", toName( var ).ascii(), delta );
 
         if ( !_basicVariables.exists( var ) )
         {
@@ -1994,7 +2437,7 @@ public:
             ++_brokenReluStat;
             ++_brokenReluFixByUpdate;
 
-            log( Stringf( "Var %s isn't basic; no pivot needed, simply updating\n", toName( var ).ascii() ) );
+            SOLVER_LOG( _log, LOG_RELU, LOG_DEBUG, "Var %s isn't basic; no pivot needed, simply updating\n", toName( var ).ascii() );
             update( var, delta, true );
             return true;
         }
@@ -2007,8 +2450,8 @@ public:
             if ( !findPivotCandidate( var, increase, pivotCandidate ) )
                 return false;
 
-            log( Stringf( "\nPivotAndUpdate: <%s, %5.2lf, %s>\n",
-                          toName( var ).ascii(), delta, toName( pivotCandidate ).ascii() ) );
+            SOLVER_LOG( _log, LOG_RELU, LOG_DEBUG, "\nPivotAndUpdate: <%s, %5.2lf, %s>\n",
+                        toName( var ).ascii(), delta, toName( pivotCandidate ).ascii() );
 
             DEBUG(
                   if ( outOfBounds( var ) )
@@ -2037,24 +2480,24 @@ public:
         if ( FloatUtils::isZero( delta ) )
             return;
 
-        log( Stringf( "\t\tUpdate: %s += %.2lf\n", toName( variable ).ascii(), delta ) );
+        SOLVER_LOG( _log, LOG_SIMPLEX, LOG_TRACE, "\t\tUpdate: %s += %.2lf\n", toName( variable ).ascii(), delta );
 
         _assignment[variable] += delta;
         turnAlmostZeroToZero( _assignment[variable] );
         computeVariableStatus( variable );
 
-        const Tableau::Entry *columnEntry = _tableau.getColumn( variable );
-        const Tableau::Entry *current;
+        Tableau::Iterator columnEntry = _tableau.getColumn( variable );
+        Tableau::Iterator current;
 
-        while ( columnEntry != NULL )
+        while ( !columnEntry.atEnd() )
         {
             current = columnEntry;
-            columnEntry = columnEntry->nextInColumn();
+            columnEntry.advance();
 
-            unsigned row = current->getRow();
+            unsigned row = current.getRow();
             if ( row != variable )
             {
-                _assignment[row] += delta * current->getValue();
+                _assignment[row] += delta * current.getValue();
                 turnAlmostZeroToZero( _assignment[row] );
                 computeVariableStatus( row );
             }
@@ -2068,38 +2511,38 @@ public:
             unsigned b = variableIsF ? partner : variable;
             unsigned f = variableIsF ? variable : partner;
 
-            log( Stringf( "Update was on relu. Parnter = %u\n", partner ) );
+            SOLVER_LOG( _log, LOG_SIMPLEX, LOG_TRACE, "Update was on relu. Parnter = %u\n", partner );
 
             // If the partner is basic, it's okay for the pair to be broken
             if ( _basicVariables.exists( partner ) )
             {
-                log( "Partner is basic. ignoring...\n" );
+                SOLVER_LOG( _log, LOG_SIMPLEX, LOG_TRACE, "Partner is basic. ignoring...\n" );
                 return;
             }
 
             // The partner is NOT basic. If the connection is broken,
             // we can fix the partner, if needed.
 
-            log( "Parnter is NOT basic. Checking if more work is needed...\n" );
+            SOLVER_LOG( _log, LOG_SIMPLEX, LOG_TRACE, "Parnter is NOT basic. Checking if more work is needed...\n" );
 
-            log( Stringf( "b = %u, f = %u, bVal = %lf, fVal = %lf\n", b, f, _assignment[b], _assignment[f] ) );
+            SOLVER_LOG( _log, LOG_SIMPLEX, LOG_TRACE, "b = %u, f = %u, bVal = %lf, fVal = %lf\n", b, f, _assignment[b], _assignment[f] );
 
             if ( _dissolvedReluVariables.exists( f ) )
             {
-                log( "Pair has been disolved, don't care about a violation\n" );
+                SOLVER_LOG( _log, LOG_SIMPLEX, LOG_TRACE, "Pair has been disolved, don't care about a violation\n" );
                 return;
             }
 
             if ( !reluPairIsBroken( b, f ) )
             {
-                log( "relu pair is NOT broken\n" );
+                SOLVER_LOG( _log, LOG_SIMPLEX, LOG_TRACE, "relu pair is NOT broken\n" );
                 return;
             }
 
             if ( variableIsF )
             {
                 // We need to fix B. This means setting the value of B to that of F.
-                log( Stringf( "Cascading update: fixing non-basic relu partner b = %u\n", b ) );
+                SOLVER_LOG( _log, LOG_SIMPLEX, LOG_TRACE, "Cascading update: fixing non-basic relu partner b = %u\n", b );
                 update( b, _assignment[f] - _assignment[b], true );
 
                 DEBUG(
@@ -2112,7 +2555,7 @@ public:
             {
                 // We need to fix F. This means setting the value of F to 0 if B is negative,
                 // and otherwise just setting it to B.
-                log( Stringf( "Cascading update: fixing non-basic relu partner f = %u\n", f ) );
+                SOLVER_LOG( _log, LOG_SIMPLEX, LOG_TRACE, "Cascading update: fixing non-basic relu partner f = %u\n", f );
                 if ( FloatUtils::isNegative( _assignment[b] ) )
                     update( f, -_assignment[f], true );
                 else
@@ -2131,7 +2574,7 @@ public:
     {
         ++_numPivots;
 
-        log( Stringf( "\t\tPivot: %s <--> %s\n", toName( basic ).ascii(), toName( nonBasic ).ascii() ) );
+        SOLVER_LOG( _log, LOG_SIMPLEX, LOG_TRACE, "\t\tPivot: %s <--> %s\n", toName( basic ).ascii(), toName( nonBasic ).ascii() );
 
         // Sanity checks:
         if ( _basicVariables.exists( nonBasic ) )
@@ -2143,6 +2586,8 @@ public:
 
         _basicVariables.erase( basic );
         _basicVariables.insert( nonBasic );
+        updateOutOfBoundsBasics( basic );
+        updateOutOfBoundsBasics( nonBasic );
 
         timeval start = Time::sampleMicro();
         unsigned numCalcs = 0;
@@ -2165,33 +2610,17 @@ public:
                                );
         _tableau.eraseRow( basic );
 
-        log( Stringf( "\t\t\tPivot--clearing %u column entries--starting\n",
-                      _tableau.getColumnSize( nonBasic ) ) );
-
-        const Tableau::Entry *columnEntry = _tableau.getColumn( nonBasic );
-        const Tableau::Entry *current;
-
-        while ( columnEntry != NULL )
-        {
-            current = columnEntry;
-            columnEntry = columnEntry->nextInColumn();
+        SOLVER_LOG( _log, LOG_SIMPLEX, LOG_TRACE, "\t\t\tPivot--clearing %u column entries--starting\n",
+                    _tableau.getColumnSize( nonBasic ) );
 
-            if ( current->getRow() != nonBasic )
-            {
-                _tableau.addScaledRow( nonBasic,
-                                       current->getValue(),
-                                       current->getRow(),
-                                       // Guarantee a 0 in the (*,nb) cells
-                                       nonBasic, 0.0,
-                                       //
-                                       &numCalcs
-                                       );
-            }
-        }
+        // Guarantee a 0 in the (*,nb) cells
+        _tableau.eliminateColumn( nonBasic, nonBasic,
+                                  _pivotThreadPool, _parallelPivotThreshold,
+                                  &numCalcs );
 
         timeval end = Time::sampleMicro();
-        log( Stringf( "\t\t\tPivot--clearing column entries--done (Pivot: %u milli, %u calcs)\n",
-                      Time::timePassed( start, end ), numCalcs ) );
+        SOLVER_LOG( _log, LOG_SIMPLEX, LOG_TRACE, "\t\t\tPivot--clearing column entries--done (Pivot: %u milli, %u calcs)\n",
+                    Time::timePassed( start, end ), numCalcs );
 
         _totalPivotTimeMilli += Time::timePassed( start, end );
         _totalPivotCalculationCount += numCalcs;
@@ -2202,56 +2631,56 @@ public:
         if ( !_dumpStates )
             return;
 
-        log( "\nVisiting state:\n" );
+        SOLVER_LOG( _log, LOG_SEARCH, LOG_TRACE, "\nVisiting state:\n" );
 
-        log( "\n" );
-        log( "       | " );
+        SOLVER_LOG( _log, LOG_SEARCH, LOG_TRACE, "\n" );
+        SOLVER_LOG( _log, LOG_SEARCH, LOG_TRACE, "       | " );
         for ( unsigned i = 0; i < _numVariables; ++i )
-            log( Stringf( "%6s", toName( i ).ascii() ) );
-        log( " | Assignment               " );
-        log( "\n" );
+            SOLVER_LOG( _log, LOG_SEARCH, LOG_TRACE, "%6s", toName( i ).ascii() );
+        SOLVER_LOG( _log, LOG_SEARCH, LOG_TRACE, " | Assignment               " );
+        SOLVER_LOG( _log, LOG_SEARCH, LOG_TRACE, "\n" );
         for ( unsigned i = 0; i < 9 + ( _numVariables * 6 ) + 13 + 15; ++i )
-            log( "-" );
-        log( "\n" );
+            SOLVER_LOG( _log, LOG_SEARCH, LOG_TRACE, "-" );
+        SOLVER_LOG( _log, LOG_SEARCH, LOG_TRACE, "\n" );
 
         for ( unsigned i = 0; i < _numVariables; ++i )
         {
             if ( _basicVariables.exists( i ) )
-                log( " B " );
+                SOLVER_LOG( _log, LOG_SEARCH, LOG_TRACE, " B " );
             else
-                log( "   " );
+                SOLVER_LOG( _log, LOG_SEARCH, LOG_TRACE, "   " );
 
-            log( Stringf( "%4s| ", toName( i ).ascii() ) );
+            SOLVER_LOG( _log, LOG_SEARCH, LOG_TRACE, "%4s| ", toName( i ).ascii() );
             for ( unsigned j = 0; j < _numVariables; ++j )
             {
                 if ( !FloatUtils::isZero( _tableau.getCell( i, j ) ) )
-                    log( Stringf( "%6.2lf", _tableau.getCell( i, j ) ) );
+                    SOLVER_LOG( _log, LOG_SEARCH, LOG_TRACE, "%6.2lf", _tableau.getCell( i, j ) );
                 else
-                    log( "      " );
+                    SOLVER_LOG( _log, LOG_SEARCH, LOG_TRACE, "      " );
             }
-            log( " | " );
+            SOLVER_LOG( _log, LOG_SEARCH, LOG_TRACE, " | " );
 
             if ( _lowerBounds[i].finite() )
-                log( Stringf( "%5.2lf <= ", _lowerBounds[i].getBound() ) );
+                SOLVER_LOG( _log, LOG_SEARCH, LOG_TRACE, "%5.2lf <= ", _lowerBounds[i].getBound() );
             else
-                log( "         " );
+                SOLVER_LOG( _log, LOG_SEARCH, LOG_TRACE, "         " );
 
-            log( Stringf( "%5.2lf", _assignment[i] ) );
+            SOLVER_LOG( _log, LOG_SEARCH, LOG_TRACE, "%5.2lf", _assignment[i] );
 
             if ( outOfBounds( i ) || ( activeReluVariable( i ) && partOfBrokenRelu( i ) ) )
-                log( " * " );
+                SOLVER_LOG( _log, LOG_SEARCH, LOG_TRACE, " * " );
             else
-                log( "   " );
+                SOLVER_LOG( _log, LOG_SEARCH, LOG_TRACE, "   " );
 
             if ( _upperBounds[i].finite() )
-                log( Stringf( "<= %5.2lf", _upperBounds[i].getBound() ) );
+                SOLVER_LOG( _log, LOG_SEARCH, LOG_TRACE, "<= %5.2lf", _upperBounds[i].getBound() );
             else
-                log( "         " );
+                SOLVER_LOG( _log, LOG_SEARCH, LOG_TRACE, "         " );
 
-            log( "\n" );
+            SOLVER_LOG( _log, LOG_SEARCH, LOG_TRACE, "\n" );
         }
 
-        log( "\n" );
+        SOLVER_LOG( _log, LOG_SEARCH, LOG_TRACE, "\n" );
     }
 
     bool canAddToNonBasic( unsigned variable, double delta )
@@ -2292,28 +2721,28 @@ public:
 
     bool tooLow( unsigned variable ) const
     {
-        return _varToStatus.at( variable ) == VariableStatus::BELOW_LB;
+        return _varToStatus[variable] == VariableStatus::BELOW_LB;
     }
 
     bool canDecrease( unsigned variable ) const
     {
         return
-            _varToStatus.at( variable ) == VariableStatus::BETWEEN ||
-            _varToStatus.at( variable ) == VariableStatus::AT_UB ||
-            _varToStatus.at( variable ) == VariableStatus::ABOVE_UB;
+            _varToStatus[variable] == VariableStatus::BETWEEN ||
+            _varToStatus[variable] == VariableStatus::AT_UB ||
+            _varToStatus[variable] == VariableStatus::ABOVE_UB;
     }
 
     bool tooHigh( unsigned variable ) const
     {
-        return _varToStatus.at( variable ) == VariableStatus::ABOVE_UB;
+        return _varToStatus[variable] == VariableStatus::ABOVE_UB;
     }
 
     bool canIncrease( unsigned variable ) const
     {
         return
-            _varToStatus.at( variable ) == VariableStatus::BETWEEN ||
-            _varToStatus.at( variable ) == VariableStatus::AT_LB ||
-            _varToStatus.at( variable ) == VariableStatus::BELOW_LB;
+            _varToStatus[variable] == VariableStatus::BETWEEN ||
+            _varToStatus[variable] == VariableStatus::AT_LB ||
+            _varToStatus[variable] == VariableStatus::BELOW_LB;
     }
 
     bool outOfBounds( unsigned variable ) const
@@ -2321,20 +2750,20 @@ public:
         return tooLow( variable ) || tooHigh( variable );
     }
 
-    void log( String message )
-    {
-        if ( _logging )
-            printf( "%s", message.ascii() );
-    }
-
     double getAssignment( unsigned variable ) const
     {
         return _assignment[variable];
     }
 
+    // Turn all logging on or off. Use getLog() for finer control.
     void setLogging( bool value )
     {
-        _logging = value;
+        _log.setLevel( value ? LOG_TRACE : LOG_NONE );
+    }
+
+    SolverLog &getLog()
+    {
+        return _log;
     }
 
     void setDumpStates( bool value )
@@ -2347,30 +2776,35 @@ public:
         return _numCallsToProgress;
     }
 
+    unsigned getMaximalStackDepth() const
+    {
+        return _maximalStackDepth;
+    }
+
     bool fixedAtZero( unsigned var ) const
     {
         return
-            ( _varToStatus.get( var ) == VariableStatus::FIXED ) &&
+            ( _varToStatus[var] == VariableStatus::FIXED ) &&
             FloatUtils::isZero( _upperBounds[var].getBound() );
     }
 
     bool eliminateAuxVariables()
     {
-        log( "eliminateAuxVariables starting\n" );
+        SOLVER_LOG( _log, LOG_SIMPLEX, LOG_DEBUG, "eliminateAuxVariables starting\n" );
         computeVariableStatus();
 
-        Set<unsigned> initialAuxVariables = _basicVariables;
+        IndexSet initialAuxVariables = _basicVariables;
 
         for ( const auto &aux : initialAuxVariables )
         {
             if ( !eliminateIfPossible( aux ) )
             {
-                log( "eliminateAuxVariables finished UNsuccessfully\n" );
+                SOLVER_LOG( _log, LOG_SIMPLEX, LOG_DEBUG, "eliminateAuxVariables finished UNsuccessfully\n" );
                 return false;
             }
         }
 
-        log( "eliminateAuxVariables finished successfully\n" );
+        SOLVER_LOG( _log, LOG_SIMPLEX, LOG_DEBUG, "eliminateAuxVariables finished successfully\n" );
         return true;
     }
 
@@ -2389,14 +2823,14 @@ public:
 
         unsigned pivotCandidate;
         if ( !findPivotCandidate( var, increase, pivotCandidate, false ) ){
-            log("Can't findPivotCandidate for a variable\n");
+            SOLVER_LOG( _log, LOG_SIMPLEX, LOG_DEBUG, "Can't findPivotCandidate for a variable\n" );
             return true;
         }
 
-        log( Stringf( "\nPivotAndUpdate: <%s, %5.2lf, %s>\n",
-                      toName( var ).ascii(),
-                      delta,
-                      toName( pivotCandidate ).ascii() ) );
+        SOLVER_LOG( _log, LOG_SIMPLEX, LOG_DEBUG, "\nPivotAndUpdate: <%s, %5.2lf, %s>\n",
+                    toName( var ).ascii(),
+                    delta,
+                    toName( pivotCandidate ).ascii() );
 
         pivot( pivotCandidate, var );
         update( var, delta );
@@ -2407,7 +2841,7 @@ public:
             return true;
         }
 
-        log( Stringf( "\nVariable %s fixed at zero. Eliminating...\n", toName( var ).ascii() ) );
+        SOLVER_LOG( _log, LOG_SIMPLEX, LOG_DEBUG, "\nVariable %s fixed at zero. Eliminating...\n", toName( var ).ascii() );
         _tableau.eraseColumn( var );
         _eliminatedVars.insert( var );
         ++_numEliminatedVars;
@@ -2418,8 +2852,8 @@ public:
     bool findPivotCandidate( unsigned variable, bool increase, unsigned &pivotCandidate,
                              bool ensureNumericalStability = true )
     {
-        const Tableau::Entry *rowEntry = _tableau.getRow( variable );
-        const Tableau::Entry *current;
+        Tableau::Iterator rowEntry = _tableau.getRow( variable );
+        Tableau::Iterator current;
 
         unsigned column;
 
@@ -2427,18 +2861,18 @@ public:
         unsigned leastEvilNonBasic = 0;
         double leastEvilWeight = 0.0;
 
-        while ( rowEntry != NULL )
+        while ( !rowEntry.atEnd() )
         {
             current = rowEntry;
-            rowEntry = rowEntry->nextInRow();
+            rowEntry.advance();
 
-            column = current->getColumn();
+            column = current.getColumn();
 
             // Ignore self
             if ( column == variable )
                 continue;
 
-            const double coefficient = current->getValue();
+            const double coefficient = current.getValue();
             bool positive = FloatUtils::isPositive( coefficient );
 
             if ( !( ( increase && ( positive ) && canIncrease( column ) ) ||
@@ -2468,7 +2902,7 @@ public:
 
         if ( found )
         {
-            log( Stringf( "findPivotCandidate: forced to pick a bad candidate! Weight = %lf\n", leastEvilWeight ) );
+            SOLVER_LOG( _log, LOG_SIMPLEX, LOG_TRACE, "findPivotCandidate: forced to pick a bad candidate! Weight = %lf\n", leastEvilWeight );
             pivotCandidate = leastEvilNonBasic;
             return true;
         }
@@ -2506,7 +2940,7 @@ public:
         return _upperBounds[var].getBound();
     }
 
-    Set<unsigned> getBasicVariables() const
+    const IndexSet &getBasicVariables() const
     {
         return _basicVariables;
     }
@@ -2516,27 +2950,7 @@ public:
         return &_reluPairs;
     }
 
-    void setLowerBounds( const List<VariableBound> &lowerBounds )
-    {
-        unsigned i = 0;
-        for ( const auto &it : lowerBounds )
-        {
-            _lowerBounds[i] = it;
-            ++i;
-        }
-    }
-
-    void setUpperBounds( const List<VariableBound> &upperBounds )
-    {
-        unsigned i = 0;
-        for ( const auto &it : upperBounds )
-        {
-            _upperBounds[i] = it;
-            ++i;
-        }
-    }
-
-    void setBasicVariables( const Set<unsigned> &basicVariables )
+    void setBasicVariables( const IndexSet &basicVariables )
     {
         _basicVariables = basicVariables;
     }
@@ -2556,10 +2970,10 @@ public:
         matrix->backupIntoMatrix( &_tableau );
 
         DEBUG(
-              log( "Printing matrix after restoration\n" );
-              log( "****\n" );
+              SOLVER_LOG( _log, LOG_SEARCH, LOG_DEBUG, "Printing matrix after restoration\n" );
+              SOLVER_LOG( _log, LOG_SEARCH, LOG_DEBUG, "****\n" );
               dump();
-              log( "****\n\n" );
+              SOLVER_LOG( _log, LOG_SEARCH, LOG_DEBUG, "****\n\n" );
               );
     }
 
@@ -2568,84 +2982,248 @@ public:
         return _assignment;
     }
 
-    void setAssignment( const List<double> &assignment )
+    void setAssignment( const double *assignment )
     {
-        unsigned i = 0;
-        for ( const auto &it : assignment )
-        {
-            _assignment[i] = it;
-            ++i;
-        }
+        memcpy( _assignment, assignment, sizeof(double) * _numVariables );
     }
 
     void makeAllBoundsFinite()
     {
         countVarsWithInfiniteBounds();
-        log( Stringf( "makeAllBoundsFinite -- Starting (%u vars with infinite bounds)\n", _varsWithInfiniteBounds ) );
-        printStatistics();
+        SOLVER_LOG( _log, LOG_BOUNDS, LOG_DEBUG, "makeAllBoundsFinite -- Starting (%u vars with infinite bounds)\n", _varsWithInfiniteBounds );
+        if ( _printStatistics )
+            printStatistics();
 
         for ( const auto &basic : _basicVariables )
             makeAllBoundsFiniteOnRow( basic );
 
         countVarsWithInfiniteBounds();
-        log( Stringf( "makeAllBoundsFinite -- Done (%u vars with infinite bounds)\n", _varsWithInfiniteBounds ) );
-        printStatistics();
+        SOLVER_LOG( _log, LOG_BOUNDS, LOG_DEBUG, "makeAllBoundsFinite -- Done (%u vars with infinite bounds)\n", _varsWithInfiniteBounds );
+        if ( _printStatistics )
+            printStatistics();
 
         if ( _varsWithInfiniteBounds != 0 )
             throw Error( Error::EXPECTED_NO_INFINITE_VARS );
     }
 
-    void makeAllBoundsFiniteOnRow( unsigned basic )
+    void symbolicBoundTightening()
     {
-        const Tableau::Entry *row = _tableau.getRow( basic );
-        const Tableau::Entry *tighteningVar = NULL;
+        SOLVER_LOG( _log, LOG_BOUNDS, LOG_DEBUG, "symbolicBoundTightening -- Starting\n" );
+
+        timeval start = Time::sampleMicro();
+
+        ++_numSymbolicBoundTightenings;
+        _symbolicBoundTightener->run( _lowerBounds, _upperBounds );
 
-        while ( row != NULL )
+        // The new bounds follow from all the bounds that the tightener used
+        unsigned level = _symbolicBoundTightener->getLevel();
+        unsigned numLearnedBounds = 0;
+
+        try
         {
-            if ( !_upperBounds[row->getColumn()].finite() || !_lowerBounds[row->getColumn()].finite() )
+            for ( unsigned layer = 1; layer < _symbolicBoundTightener->getNumLayers(); ++layer )
             {
-                if ( tighteningVar != NULL )
-                    throw Error( Error::MULTIPLE_INFINITE_VARS_ON_ROW );
-
-                tighteningVar = row;
+                for ( unsigned neuron = 0; neuron < _symbolicBoundTightener->getLayerSize( layer ); ++neuron )
+                {
+                    learnNeuronBounds( layer, neuron,
+                                       _symbolicBoundTightener->getLowerBound( layer, neuron ),
+                                       _symbolicBoundTightener->getUpperBound( layer, neuron ),
+                                       level, numLearnedBounds );
+                }
             }
-
-            row = row->nextInRow();
+        }
+        catch ( ... )
+        {
+            _symbolicBoundsLearned += numLearnedBounds;
+            timeval end = Time::sampleMicro();
+            _totalSymbolicBoundTighteningTime += Time::timePassed( start, end );
+            throw;
         }
 
-        // It's possible that there are no infinite vars on this row - e.g., if the user supplied
-        // bounds on the outputs.
-        if ( !tighteningVar )
-            return;
+        _symbolicBoundsLearned += numLearnedBounds;
+        timeval end = Time::sampleMicro();
+        _totalSymbolicBoundTighteningTime += Time::timePassed( start, end );
 
-        unsigned tighteningVarIndex = tighteningVar->getColumn();
+        SOLVER_LOG( _log, LOG_BOUNDS, LOG_DEBUG, "symbolicBoundTightening -- Done. Number of learned bounds: %u\n",
+                    numLearnedBounds );
+    }
 
-        double scale = -1.0 / tighteningVar->getValue();
+    void lpBoundTightening()
+    {
+        SOLVER_LOG( _log, LOG_BOUNDS, LOG_DEBUG, "lpBoundTightening -- Starting\n" );
 
-        row = _tableau.getRow( basic );
-        const Tableau::Entry *current;
+        timeval start = Time::sampleMicro();
 
-        double max = 0.0;
-        double min = 0.0;
+        LpBoundTightener lpBoundTightener( *_symbolicBoundTightener, _lpTighteningThreads );
+        lpBoundTightener.run( _lowerBounds, _upperBounds );
 
-        while ( row != NULL )
-        {
-            current = row;
-            row = row->nextInRow();
+        _numLpBoundTighteningLps += lpBoundTightener.getNumLpsSolved() + lpBoundTightener.getNumLpsFailed();
+        _numLpBoundTighteningFailures += lpBoundTightener.getNumLpsFailed();
 
-            if ( current->getColumn() == tighteningVarIndex )
+        // This only happens before solving, so all bounds are at level 0
+        unsigned numLearnedBounds = 0;
+
+        try
+        {
+            for ( unsigned layer = 1; layer < _symbolicBoundTightener->getNumLayers(); ++layer )
+            {
+                for ( unsigned neuron = 0; neuron < _symbolicBoundTightener->getLayerSize( layer ); ++neuron )
+                {
+                    learnNeuronBounds( layer, neuron,
+                                       lpBoundTightener.getLowerBound( layer, neuron ),
+                                       lpBoundTightener.getUpperBound( layer, neuron ),
+                                       0, numLearnedBounds );
+                }
+            }
+        }
+        catch ( ... )
+        {
+            _lpBoundsLearned += numLearnedBounds;
+            timeval end = Time::sampleMicro();
+            _totalLpBoundTighteningTime += Time::timePassed( start, end );
+            throw;
+        }
+
+        _lpBoundsLearned += numLearnedBounds;
+        timeval end = Time::sampleMicro();
+        _totalLpBoundTighteningTime += Time::timePassed( start, end );
+
+        SOLVER_LOG( _log, LOG_BOUNDS, LOG_DEBUG, "lpBoundTightening -- Done. Number of learned bounds: %u\n",
+                    numLearnedBounds );
+    }
+
+    void computeReluLayers()
+    {
+        _reluLayers.clear();
+        for ( unsigned layer = 1; layer < _symbolicBoundTightener->getNumLayers(); ++layer )
+        {
+            if ( !_symbolicBoundTightener->hasRelu( layer ) )
                 continue;
 
-            double coefficient = current->getValue() * scale;
+            for ( unsigned neuron = 0; neuron < _symbolicBoundTightener->getLayerSize( layer ); ++neuron )
+                _reluLayers[_symbolicBoundTightener->getFVariable( layer, neuron )] = layer;
+        }
+    }
+
+    // Apply bounds computed for the b variable of a neuron to its b and f variables
+    void learnNeuronBounds( unsigned layer, unsigned neuron, double lb, double ub, unsigned level,
+                            unsigned &numLearnedBounds )
+    {
+        unsigned b = _symbolicBoundTightener->getBVariable( layer, neuron );
+        if ( !_lowerBounds[b].finite() || FloatUtils::gt( lb, _lowerBounds[b].getBound() ) )
+        {
+            ++numLearnedBounds;
+            updateLowerBound( b, lb, level );
+        }
+        if ( !_upperBounds[b].finite() || FloatUtils::lt( ub, _upperBounds[b].getBound() ) )
+        {
+            ++numLearnedBounds;
+            updateUpperBound( b, ub, level );
+        }
+
+        if ( !_symbolicBoundTightener->hasRelu( layer ) )
+            return;
+
+        // Bounds on b usually carry over to f, but not once the pair has been dissolved
+        unsigned f = _symbolicBoundTightener->getFVariable( layer, neuron );
+        if ( FloatUtils::isPositive( lb ) && FloatUtils::gt( lb, _lowerBounds[f].getBound() ) )
+        {
+            ++numLearnedBounds;
+            updateLowerBound( f, lb, level );
+        }
+        double fUpper = FloatUtils::isPositive( ub ) ? ub : 0.0;
+        if ( !_upperBounds[f].finite() || FloatUtils::lt( fUpper, _upperBounds[f].getBound() ) )
+        {
+            ++numLearnedBounds;
+            updateUpperBound( f, fUpper, level );
+        }
+    }
+
+    /*
+      Bounds given with setLowerBound() and setUpperBound() (e.g., from interval analysis of the
+      network) may already determine the phase of a ReLU pair. Such pairs are split or merged
+      here, exactly as if their bounds had been learned by updateLowerBound() and
+      updateUpperBound().
+    */
+    void fixStableRelus()
+    {
+        unsigned fixed = 0;
+
+        // Merging a pair changes the tableau, but not the set of pairs
+        for ( const auto &pair : _reluPairs.getPairs() )
+        {
+            unsigned b = pair.getB();
+            unsigned f = pair.getF();
+
+            if ( _dissolvedReluVariables.exists( f ) )
+                continue;
+
+            if ( _upperBounds[b].finite() && !FloatUtils::isPositive( _upperBounds[b].getBound() ) )
+            {
+                updateUpperBound( b, _upperBounds[b].getBound(), 0 );
+                ++fixed;
+            }
+            else if ( _lowerBounds[b].finite() && !FloatUtils::isNegative( _lowerBounds[b].getBound() ) )
+            {
+                updateLowerBound( b, _lowerBounds[b].getBound(), 0 );
+                ++fixed;
+            }
+        }
+
+        SOLVER_LOG( _log, LOG_BOUNDS, LOG_DEBUG, "fixStableRelus -- Done (%u pairs fixed)\n", fixed );
+    }
+
+    void makeAllBoundsFiniteOnRow( unsigned basic )
+    {
+        Tableau::Iterator row = _tableau.getRow( basic );
+        Tableau::Iterator tighteningVar;
+
+        while ( !row.atEnd() )
+        {
+            if ( !_upperBounds[row.getColumn()].finite() || !_lowerBounds[row.getColumn()].finite() )
+            {
+                if ( !tighteningVar.atEnd() )
+                    throw Error( Error::MULTIPLE_INFINITE_VARS_ON_ROW );
+
+                tighteningVar = row;
+            }
+
+            row.advance();
+        }
+
+        // It's possible that there are no infinite vars on this row - e.g., if the user supplied
+        // bounds on the outputs.
+        if ( tighteningVar.atEnd() )
+            return;
+
+        unsigned tighteningVarIndex = tighteningVar.getColumn();
+
+        double scale = -1.0 / tighteningVar.getValue();
+
+        row = _tableau.getRow( basic );
+        Tableau::Iterator current;
+
+        double max = 0.0;
+        double min = 0.0;
+
+        while ( !row.atEnd() )
+        {
+            current = row;
+            row.advance();
+
+            if ( current.getColumn() == tighteningVarIndex )
+                continue;
+
+            double coefficient = current.getValue() * scale;
             if ( FloatUtils::isPositive( coefficient ) )
             {
-                max += _upperBounds[current->getColumn()].getBound() * coefficient;
-                min += _lowerBounds[current->getColumn()].getBound() * coefficient;
+                max += _upperBounds[current.getColumn()].getBound() * coefficient;
+                min += _lowerBounds[current.getColumn()].getBound() * coefficient;
             }
             else
             {
-                min += _upperBounds[current->getColumn()].getBound() * coefficient;
-                max += _lowerBounds[current->getColumn()].getBound() * coefficient;
+                min += _upperBounds[current.getColumn()].getBound() * coefficient;
+                max += _lowerBounds[current.getColumn()].getBound() * coefficient;
             }
         }
 
@@ -2696,9 +3274,9 @@ public:
 
     void markReluVariableDissolved( unsigned variable, ReluDissolutionType type )
     {
-        log( Stringf( "Mark var as dissolved: %u (Type: %s)\n",
-                      variable,
-                      type == TYPE_SPLIT ? "Split" : "Merge" ) );
+        SOLVER_LOG( _log, LOG_RELU, LOG_DEBUG, "Mark var as dissolved: %u (Type: %s)\n",
+                    variable,
+                    type == TYPE_SPLIT ? "Split" : "Merge" );
 
         DEBUG(
               if ( _dissolvedReluVariables.exists( variable ) )
@@ -2708,7 +3286,20 @@ public:
               }
               );
 
+        trailReluDissolution( variable );
         _dissolvedReluVariables[variable] = type;
+        updateBrokenReluPairs( variable );
+
+        _smtCore.notifyReluDissolved( variable, type );
+    }
+
+    bool isDissolvedReluPair( unsigned f, ReluDissolutionType &type ) const
+    {
+        if ( !_dissolvedReluVariables.exists( f ) )
+            return false;
+
+        type = _dissolvedReluVariables.at( f );
+        return true;
     }
 
     void incNumSplits()
@@ -2749,13 +3340,99 @@ public:
         return _tableau.getColumnSize( column );
     }
 
-    Map<unsigned, ReluDissolutionType> getDissolvedReluPairs() const
+    unsigned getTrailSize() const
+    {
+        return _trail.size();
+    }
+
+    // Undo the bound changes and ReLU dissolutions recorded since the trail had the given size
+    void undoTrail( unsigned trailSize )
+    {
+        while ( _trail.size() > trailSize )
+        {
+            TrailEntry entry = _trail.pop();
+
+            switch ( entry._type )
+            {
+            case TrailEntry::LOWER_BOUND:
+                _lowerBounds[entry._variable] = entry._bound;
+                break;
+
+            case TrailEntry::UPPER_BOUND:
+                _upperBounds[entry._variable] = entry._bound;
+                break;
+
+            case TrailEntry::RELU_DISSOLUTION:
+                if ( entry._wasDissolved )
+                    _dissolvedReluVariables[entry._variable] = entry._dissolutionType;
+                else
+                    _dissolvedReluVariables.erase( entry._variable );
+                updateBrokenReluPairs( entry._variable );
+                break;
+            }
+        }
+    }
+
+    // Changes made while the stack is empty are never undone, so they are not recorded
+    bool trailIsActive() const
     {
-        return _dissolvedReluVariables;
+        return _smtCore.getStackDepth() > 0;
     }
 
-    void setDissolvedReluPairs( const Map<unsigned, ReluDissolutionType> &pairs )
+    void trailLowerBound( unsigned variable )
     {
+        if ( !trailIsActive() )
+            return;
+
+        TrailEntry entry;
+        entry._type = TrailEntry::LOWER_BOUND;
+        entry._variable = variable;
+        entry._bound = _lowerBounds[variable];
+        _trail.append( entry );
+    }
+
+    void trailUpperBound( unsigned variable )
+    {
+        if ( !trailIsActive() )
+            return;
+
+        TrailEntry entry;
+        entry._type = TrailEntry::UPPER_BOUND;
+        entry._variable = variable;
+        entry._bound = _upperBounds[variable];
+        _trail.append( entry );
+    }
+
+    void trailReluDissolution( unsigned variable )
+    {
+        if ( !trailIsActive() )
+            return;
+
+        TrailEntry entry;
+        entry._type = TrailEntry::RELU_DISSOLUTION;
+        entry._variable = variable;
+        entry._wasDissolved = _dissolvedReluVariables.exists( variable );
+        entry._dissolutionType = entry._wasDissolved ? _dissolvedReluVariables[variable] : TYPE_SPLIT;
+        _trail.append( entry );
+    }
+
+    void restoreDissolvedReluVariables( const IndexMap<ReluDissolutionType> &pairs )
+    {
+        if ( trailIsActive() )
+        {
+            for ( const auto &pair : _dissolvedReluVariables )
+            {
+                if ( !pairs.exists( pair.first ) || pairs.get( pair.first ) != pair.second )
+                    trailReluDissolution( pair.first );
+            }
+
+            for ( const auto &pair : pairs )
+            {
+                if ( !_dissolvedReluVariables.exists( pair.first ) )
+                    trailReluDissolution( pair.first );
+            }
+        }
+
         _dissolvedReluVariables = pairs;
     }
 
@@ -2796,12 +3473,12 @@ public:
         return _numVariables;
     }
 
-    const Tableau::Entry *getColumn( unsigned column ) const
+    Tableau::Iterator getColumn( unsigned column ) const
     {
         return _tableau.getColumn( column );
     }
 
-    const Tableau::Entry *getRow( unsigned row ) const
+    Tableau::Iterator getRow( unsigned row ) const
     {
         return _tableau.getRow( row );
     }
@@ -2836,6 +3513,56 @@ public:
             _preprocessedLowerBounds[i] = _lowerBounds[i];
             _preprocessedUpperBounds[i] = _upperBounds[i];
         }
+
+        storeFactorizedTableauSize();
+    }
+
+    void storeFactorizedTableauSize()
+    {
+        _factorizedTableauSize = _tableau.totalSize();
+        _factorizedMaxEntry = _tableau.maxAbsoluteEntry();
+        _pivotsAtLastFillInCheck = _numPivots;
+    }
+
+    // Check how much the tableau has grown since it was last rebuilt
+    bool fillInLimitExceeded()
+    {
+        if ( _numPivots == _pivotsAtLastFillInCheck )
+            return false;
+        _pivotsAtLastFillInCheck = _numPivots;
+
+        unsigned size = _tableau.totalSize();
+        if ( size > _peakTableauSize )
+            _peakTableauSize = size;
+
+        double fillInGrowth = ( _factorizedTableauSize > 0 ) ? ((double)size) / _factorizedTableauSize : 1.0;
+        if ( fillInGrowth > _peakFillInGrowth )
+            _peakFillInGrowth = fillInGrowth;
+
+        if ( ( _maxFillInGrowth > 0 ) && ( fillInGrowth > _maxFillInGrowth ) )
+        {
+            SOLVER_LOG( _log, LOG_SIMPLEX, LOG_DEBUG, "Fill-in limit exceeded: %u entries, %u after the last refactorization\n",
+                        size, _factorizedTableauSize );
+            return true;
+        }
+
+        // Scanning for the largest entry costs as much as a pass over the tableau
+        if ( ( _maxEntryGrowth == 0 ) && ( _numCallsToProgress % PRINT_STATISTICS != 0 ) )
+            return false;
+
+        double maxEntry = _tableau.maxAbsoluteEntry();
+        double entryGrowth = ( _factorizedMaxEntry > 0 ) ? maxEntry / _factorizedMaxEntry : 1.0;
+        if ( entryGrowth > _peakEntryGrowth )
+            _peakEntryGrowth = entryGrowth;
+
+        if ( ( _maxEntryGrowth > 0 ) && ( entryGrowth > _maxEntryGrowth ) )
+        {
+            SOLVER_LOG( _log, LOG_SIMPLEX, LOG_DEBUG, "Entry growth limit exceeded: largest entry is %.2lf, was %.2lf after the last refactorization\n",
+                        maxEntry, _factorizedMaxEntry );
+            return true;
+        }
+
+        return false;
     }
 
     void restoreTableauFromBackup( bool keepCurrentBasicVariables = true )
@@ -2850,7 +3577,7 @@ public:
         unsigned *backupLowerBoundLevels = new unsigned[_numVariables];
         unsigned *backupUpperBoundLevels = new unsigned[_numVariables];
 
-        Set<unsigned> backupBasicVariables = _basicVariables;
+        IndexSet backupBasicVariables = _basicVariables;
 
         for ( unsigned i = 0; i < _numVariables; ++i )
         {
@@ -2879,17 +3606,19 @@ public:
             backupLowerBoundLevels[i] = _lowerBounds[i].getLevel();
             backupUpperBoundLevels[i] = _upperBounds[i].getLevel();
 
+            trailLowerBound( i );
+            trailUpperBound( i );
             _lowerBounds[i] = _preprocessedLowerBounds[i];
             _upperBounds[i] = _preprocessedUpperBounds[i];
             _lowerBounds[i].setLevel( 0 );
             _upperBounds[i].setLevel( 0 );
         }
 
-        Map<unsigned, ReluDissolutionType> backupDissolved = _dissolvedReluVariables;
+        IndexMap<ReluDissolutionType> backupDissolved = _dissolvedReluVariables;
 
         // First restore the original tableau and the state of relus
         _preprocessedTableau.backupIntoMatrix( &_tableau );
-        _dissolvedReluVariables = _preprocessedDissolvedRelus;
+        restoreDissolvedReluVariables( _preprocessedDissolvedRelus );
         memcpy( _assignment, _preprocessedAssignment, sizeof(double) * _numVariables );
         _basicVariables = _preprocessedBasicVariables;
         computeVariableStatus();
@@ -2948,6 +3677,7 @@ public:
                     updateUpperBound( b, bUpper, backupUpperBoundLevels[b] );
 
                 // Maybe the pair was broken at an earlier update, so fix F's levels individually.
+                trailUpperBound( f );
                 _upperBounds[f].setLevel( backupUpperBoundLevels[f] );
 
                 // Also, normally update b's lower bound
@@ -3105,8 +3835,8 @@ public:
         if ( keepCurrentBasicVariables )
         {
             printf( "\t\t\tRestoring basics\n" );
-            Set<unsigned> shouldBeBasic = Set<unsigned>::difference( backupBasicVariables, _basicVariables );
-            Set<unsigned> shouldntBeBasic = Set<unsigned>::difference( _basicVariables, backupBasicVariables );
+            IndexSet shouldBeBasic = IndexSet::difference( backupBasicVariables, _basicVariables );
+            IndexSet shouldntBeBasic = IndexSet::difference( _basicVariables, backupBasicVariables );
 
             adjustBasicVariables( shouldBeBasic, shouldntBeBasic );
         }
@@ -3122,34 +3852,36 @@ public:
         delete[] backupUpperBounds;
         delete[] backupLowerBounds;
 
+        storeFactorizedTableauSize();
+
         timeval end = Time::sampleMicro();
         _totalRestorationTimeMilli += Time::timePassed( start, end );
 
         printf( "\n\n\t\t !!! Restore tableau from backup DONE !!!\n" );
     }
 
-    void adjustBasicVariables( const Set<unsigned> &shouldBeBasic, Set<unsigned> shouldntBeBasic, bool adjustAssignment = true )
+    void adjustBasicVariables( const IndexSet &shouldBeBasic, IndexSet shouldntBeBasic, bool adjustAssignment = true )
     {
         unsigned count = 0;
         for ( const auto &entering : shouldBeBasic )
         {
-            const Tableau::Entry *columnEntry = _tableau.getColumn( entering );
-            const Tableau::Entry *current;
+            Tableau::Iterator columnEntry = _tableau.getColumn( entering );
+            Tableau::Iterator current;
 
             bool done = false;
-            while ( !done && columnEntry != NULL )
+            while ( !done && !columnEntry.atEnd() )
             {
                 current = columnEntry;
-                columnEntry = columnEntry->nextInColumn();
+                columnEntry.advance();
 
-                unsigned leaving = current->getRow();
+                unsigned leaving = current.getRow();
                 if ( shouldntBeBasic.exists( leaving ) )
                 {
                     double weight = FloatUtils::abs( getCell( leaving, entering ) );
                     if ( FloatUtils::lt( weight, NUMBERICAL_INSTABILITY_CONSTANT ) )
                     {
-                        log( Stringf( "adjustBasicVariables: skipping a bad pivot: %.10lf\n",
-                                      getCell( leaving, entering ) ) );
+                        SOLVER_LOG( _log, LOG_SIMPLEX, LOG_TRACE, "adjustBasicVariables: skipping a bad pivot: %.10lf\n",
+                                    getCell( leaving, entering ) );
                         continue;
                     }
 
@@ -3194,10 +3926,14 @@ public:
 
     void fixAllBrokenRelus()
     {
-        for ( auto &pair : _reluPairs.getPairs() )
+        // Fixing a pair only changes the assignment of its own f and of basic variables
+        Vector<unsigned> brokenReluBs;
+        for ( auto b : _brokenReluBs )
+            brokenReluBs.append( b );
+
+        for ( auto b : brokenReluBs )
         {
-            unsigned b = pair.getB();
-            unsigned f = pair.getF();
+            unsigned f = _reluPairs.bToF( b );
 
             if ( ( !_dissolvedReluVariables.exists( f ) ) && reluPairIsBroken( b, f ) )
             {
@@ -3357,8 +4093,15 @@ private:
     VariableBound *_preprocessedLowerBounds;
     double *_assignment;
     double *_preprocessedAssignment;
-    Set<unsigned> _basicVariables;
-    Set<unsigned> _preprocessedBasicVariables;
+    IndexSet _basicVariables;
+    IndexSet _preprocessedBasicVariables;
+
+    // Basic variables that are currently out of bounds, maintained by computeVariableStatus()
+    SparseIndexSet _outOfBoundsBasics;
+
+    // The b variables of the active ReLU pairs that are currently broken, also maintained by
+    // computeVariableStatus()
+    SparseIndexSet _brokenReluBs;
     Map<unsigned, String> _variableNames;
     ReluPairs _reluPairs;
     SmtCore _smtCore;
@@ -3368,7 +4111,7 @@ private:
 
     GlpkWrapper::GlpkAnswer _previousGlpkAnswer;
 
-    bool _logging;
+    SolverLog _log;
     bool _dumpStates;
 
     unsigned _numCallsToProgress;
@@ -3400,15 +4143,71 @@ private:
     unsigned _numBoundsDerivedThroughGlpk;
     unsigned _numBoundsDerivedThroughGlpkOnSlacks;
     unsigned long long _totalTightenAllBoundsTime;
+    unsigned long long _boundPropagationRowVisits;
+    unsigned _boundPropagationBudgetExhausted;
 
     bool _eliminateAlmostBrokenRelus;
 
-    Map<unsigned, VariableStatus> _varToStatus;
+    VariableStatus *_varToStatus;
+
+    IndexMap<ReluDissolutionType> _dissolvedReluVariables;
+    IndexMap<ReluDissolutionType> _preprocessedDissolvedRelus;
+
+    /*
+      The trail records the previous values of bounds and of dissolved ReLU pairs as they
+      are changed, so that popping a decision only undoes what changed since it was made.
+    */
+    struct TrailEntry
+    {
+        enum Type {
+            LOWER_BOUND = 0,
+            UPPER_BOUND = 1,
+            RELU_DISSOLUTION = 2,
+        };
+
+        Type _type;
+        unsigned _variable;
+        VariableBound _bound;
+        bool _wasDissolved;
+        ReluDissolutionType _dissolutionType;
+    };
 
-    Map<unsigned, ReluDissolutionType> _dissolvedReluVariables;
-    Map<unsigned, ReluDissolutionType> _preprocessedDissolvedRelus;
+    Vector<TrailEntry> _trail;
+
+    /*
+      The lowest (LOW) and highest (HIGH) values that the terms of a row can take under the
+      current bounds. Infinite bounds are counted instead of summed, and the two highest
+      bound levels are kept, so that the contribution of any single variable can be taken
+      out without walking the row again. Likewise, the decisions that two or more bounds depend
+      on are kept apart, so that those of a single variable can be taken out too.
+    */
+    struct RowActivity
+    {
+        enum Side {
+            LOW = 0,
+            HIGH = 1,
+        };
+
+        double _sum[2];
+        unsigned _numInfinite[2];
+        unsigned _topLevel[2];
+        unsigned _topLevelVariable[2];
+        unsigned _secondLevel[2];
+        DecisionSet _decisions[2];
+        DecisionSet _sharedDecisions[2];
+    };
+
+    struct ImpliedBound
+    {
+        // False if the rest of the row has an infinite contribution
+        bool _finite;
+        double _bound;
+        unsigned _level;
+        DecisionSet _decisions;
+    };
 
     bool _printAssignment;
+    bool _printStatistics;
     Set<unsigned> _eliminatedVars;
 
     unsigned _numOutOfBoundFixes;
@@ -3428,6 +4227,17 @@ private:
     unsigned _numberOfRestorations;
     double _maxDegradation;
 
+    // Fill-in monitoring
+    double _maxFillInGrowth;
+    double _maxEntryGrowth;
+    unsigned _factorizedTableauSize;
+    double _factorizedMaxEntry;
+    unsigned _pivotsAtLastFillInCheck;
+    unsigned _peakTableauSize;
+    double _peakFillInGrowth;
+    double _peakEntryGrowth;
+    unsigned _numRefactorizations;
+
     unsigned long long _totalProgressTimeMilli;
     unsigned long long _timeTighteningGlpkBoundsMilli;
 
@@ -3470,13 +4280,64 @@ private:
     bool _useConflictAnalysis;
     bool _temporarilyDontUseSlacks;
 
-    bool _quit;
+    // Set by quit(), possibly from another thread
+    std::atomic<bool> _quit;
     bool _fullTightenAllBounds;
+    unsigned _boundPropagationMaxRowVisits;
+    double _boundPropagationMinImprovement;
+
+    // Rows waiting to be visited by propagateBounds()
+    Queue<unsigned> _boundPropagationQueue;
+    IndexSet _queuedBoundPropagationRows;
     bool _glpkExtractJustBasics;
 
     unsigned long long _totalTimeEvalutingGlpkRows;
     unsigned _consecutiveGlpkFailureCount;
 
+    ThreadPool *_pivotThreadPool;
+    unsigned _parallelPivotThreshold;
+
+    ThreadPool *_tighteningThreadPool;
+    Vector<Vector<unsigned> > _tighteningRows;
+    SparseIndexSet _rowsThatTighten;
+    SparseIndexSet _variablesChangedInBatch;
+
+    SymbolicBoundTightener *_symbolicBoundTightener;
+    Map<unsigned, unsigned> _reluLayers;
+    bool _symbolicBoundTightening;
+    bool _symbolicBoundTighteningPending;
+    unsigned _numSymbolicBoundTightenings;
+    unsigned long long _symbolicBoundsLearned;
+    unsigned long long _totalSymbolicBoundTighteningTime;
+
+    // The decisions behind the last bound violation found by boundInvariantHolds()
+    DecisionSet _violatingDecisions;
+
+    // The decisions behind the last conflict found by progress()
+    DecisionSet _conflictDecisions;
+
+    unsigned _lpTighteningThreads;
+    unsigned _numLpBoundTighteningLps;
+    unsigned _numLpBoundTighteningFailures;
+    unsigned long long _lpBoundsLearned;
+    unsigned long long _totalLpBoundTighteningTime;
+
+    unsigned _reluProbingPairs;
+    unsigned _numProbingRounds;
+    unsigned long long _numProbes;
+    unsigned _numPairsFixedByProbing;
+    unsigned _numProbingConflicts;
+    unsigned long long _totalProbingTime;
+
+    // The bounds changed by the current probe, to be restored once it is done
+    struct ProbedBound
+    {
+        unsigned _variable;
+        bool _isUpper;
+        VariableBound _bound;
+    };
+    Vector<ProbedBound> _probeTrail;
+
 public:
     void checkInvariants() const
     {
@@ -3494,11 +4355,11 @@ public:
                 exit( 1 );
             }
 
-            const Tableau::Entry *columnEntry = _tableau.getColumn( basic );
+            Tableau::Iterator columnEntry = _tableau.getColumn( basic );
 
             if ( ( _tableau.getColumnSize( basic ) != 1 ) ||
-                 ( columnEntry->getRow() != basic ) ||
-                 ( FloatUtils::areDisequal( columnEntry->getValue(), -1.0 ) ) )
+                 ( columnEntry.getRow() != basic ) ||
+                 ( FloatUtils::areDisequal( columnEntry.getValue(), -1.0 ) ) )
             {
                 printf( "Error: basic variable's column isn't right! (var: %s)\n",
                         toName( basic ).ascii() );
@@ -3507,18 +4368,18 @@ public:
                 exit( 1 );
             }
 
-            const Tableau::Entry *rowEntry = _tableau.getRow( basic );
-            const Tableau::Entry *current;
+            Tableau::Iterator rowEntry = _tableau.getRow( basic );
+            Tableau::Iterator current;
 
-            while ( rowEntry != NULL )
+            while ( !rowEntry.atEnd() )
             {
                 current = rowEntry;
-                rowEntry = rowEntry->nextInRow();
+                rowEntry.advance();
 
-                if ( current->getColumn() == basic )
+                if ( current.getColumn() == basic )
                     continue;
 
-                if ( _basicVariables.exists( current->getColumn() ) )
+                if ( _basicVariables.exists( current.getColumn() ) )
                 {
                     printf( "Error: a basic variable appears in another basic variable's row\n" );
                     exit( 1 );
@@ -3529,7 +4390,7 @@ public:
         // All non-basic are within bounds
         for ( unsigned i = 0; i < _numVariables; ++i )
         {
-            if ( _varToStatus.get( i ) == ABOVE_UB || _varToStatus.get( i ) == BELOW_LB )
+            if ( _varToStatus[i] == ABOVE_UB || _varToStatus[i] == BELOW_LB )
             {
                 // Only basic variables can be out-of-bounds
                 if ( !_basicVariables.exists( i ) )
@@ -3611,11 +4472,11 @@ public:
     {
         printf( "\n\nDumping column for %s:\n", toName( index ).ascii() );
 
-        const Tableau::Entry *columnEntry = _tableau.getColumn( index );
-        while ( columnEntry != NULL )
+        Tableau::Iterator columnEntry = _tableau.getColumn( index );
+        while ( !columnEntry.atEnd() )
         {
-            printf( "\t<%u, %.5lf>\n", columnEntry->getRow(), columnEntry->getValue() );
-            columnEntry = columnEntry->nextInColumn();
+            printf( "\t<%u, %.5lf>\n", columnEntry.getRow(), columnEntry.getValue() );
+            columnEntry.advance();
         }
     }
 
@@ -3636,7 +4497,7 @@ public:
 
     void tightenAllBounds()
     {
-        log( "tightenAllBounds -- Starting\n" );
+        SOLVER_LOG( _log, LOG_BOUNDS, LOG_DEBUG, "tightenAllBounds -- Starting\n" );
 
         timeval start = Time::sampleMicro();
 
@@ -3644,117 +4505,580 @@ public:
 
         if ( !_fullTightenAllBounds )
         {
-            Set<unsigned> copyOfBasics = _basicVariables;
+            IndexSet copyOfBasics = _basicVariables;
             for ( const auto &basic : copyOfBasics )
             {
                 if ( !_basicVariables.exists( basic ) )
                     continue;
 
+                ++_boundPropagationRowVisits;
                 tightenBoundsOnRow( basic, numLearnedBounds );
             }
         }
+        else if ( _tighteningThreadPool )
+        {
+            parallelPropagateBounds( numLearnedBounds );
+        }
         else
         {
-            bool done = false;
-            while ( !done )
+            propagateBounds( numLearnedBounds );
+        }
+
+        timeval end = Time::sampleMicro();
+        _totalTightenAllBoundsTime += Time::timePassed( start, end );
+
+        _boundsTightendByTightenAllBounds += numLearnedBounds;
+
+        SOLVER_LOG( _log, LOG_BOUNDS, LOG_DEBUG, "tightenAllBounds -- Done. Number of learned bounds: %u\n", numLearnedBounds );
+    }
+
+    /*
+      Visit every row once, and then keep revisiting the rows that contain variables whose
+      bounds have changed, until no more bounds are learned or the budget runs out. Merging a
+      ReLU pair rewrites only the rows of its columns, which all contain f afterwards, so only
+      those are revisited.
+    */
+    void propagateBounds( unsigned &numLearnedBounds )
+    {
+        for ( unsigned basic : _basicVariables )
+            enqueueBoundPropagationRow( basic );
+
+        unsigned rowVisits = 0;
+        Vector<unsigned> changedVariables;
+
+        while ( !_boundPropagationQueue.empty() )
+        {
+            if ( _boundPropagationMaxRowVisits != 0 && rowVisits >= _boundPropagationMaxRowVisits )
+            {
+                ++_boundPropagationBudgetExhausted;
+                clearBoundPropagationQueue();
+                break;
+            }
+
+            unsigned basic = _boundPropagationQueue.peak();
+            _boundPropagationQueue.pop();
+            _queuedBoundPropagationRows.erase( basic );
+
+            if ( !_basicVariables.exists( basic ) )
+                continue;
+
+            ++rowVisits;
+            ++_boundPropagationRowVisits;
+
+            changedVariables.clear();
+            bool tableauChanged = tightenBoundsOnRow( basic, numLearnedBounds, &changedVariables );
+            enqueueRowsOfVariables( changedVariables, basic, tableauChanged );
+        }
+    }
+
+    /*
+      The parallel version of propagateBounds(), which visits the same rows in the same order
+      and learns the same bounds. The threads check a batch of rows from the front of the queue
+      against the current bounds, and the calling thread then visits the batch in order. A row
+      is skipped if it was found to learn nothing and none of its variables' bounds have
+      changed since; every other row goes through tightenBoundsOnRow(). After a merge, the rest
+      of the batch is visited without skipping.
+    */
+    void parallelPropagateBounds( unsigned &numLearnedBounds )
+    {
+        for ( unsigned basic : _basicVariables )
+            enqueueBoundPropagationRow( basic );
+
+        unsigned numThreads = _tighteningThreadPool->getNumThreads();
+        unsigned rowVisits = 0;
+        Vector<unsigned> changedVariables;
+        Vector<unsigned> batch;
+        unsigned next = 0;
+
+        try
+        {
+            while ( !_boundPropagationQueue.empty() )
             {
-                bool needToRestart = false;
-                Set<unsigned>::iterator basic = _basicVariables.begin();
+                // The batch stays marked as queued until it is visited, as in propagateBounds()
+                batch.clear();
+                while ( !_boundPropagationQueue.empty() && batch.size() < PARALLEL_TIGHTENING_BATCH_SIZE )
+                {
+                    batch.append( _boundPropagationQueue.peak() );
+                    _boundPropagationQueue.pop();
+                }
 
-                while ( ( basic != _basicVariables.end() ) && !needToRestart )
+                _tighteningThreadPool->run( [this, &batch, numThreads]( unsigned thread )
                 {
-                    needToRestart = tightenBoundsOnRow( *basic, numLearnedBounds );
-                    if ( !needToRestart )
+                    Vector<unsigned> &rows( _tighteningRows[thread] );
+                    rows.clear();
+
+                    for ( unsigned i = thread; i < batch.size(); i += numThreads )
                     {
-                        ++basic;
+                        if ( _basicVariables.exists( batch[i] ) && rowTightensBounds( batch[i] ) )
+                            rows.append( batch[i] );
                     }
+                } );
+
+                _rowsThatTighten.clear();
+                for ( unsigned thread = 0; thread < numThreads; ++thread )
+                {
+                    for ( unsigned basic : _tighteningRows[thread] )
+                        _rowsThatTighten.insert( basic );
                 }
 
-                if ( !needToRestart )
-                    done = true;
+                _variablesChangedInBatch.clear();
+                bool tableauChanged = false;
+
+                for ( next = 0; next < batch.size(); ++next )
+                {
+                    if ( _boundPropagationMaxRowVisits != 0 && rowVisits >= _boundPropagationMaxRowVisits )
+                    {
+                        ++_boundPropagationBudgetExhausted;
+                        for ( ; next < batch.size(); ++next )
+                            _queuedBoundPropagationRows.erase( batch[next] );
+                        clearBoundPropagationQueue();
+                        return;
+                    }
+
+                    unsigned basic = batch[next];
+                    _queuedBoundPropagationRows.erase( basic );
+
+                    if ( !_basicVariables.exists( basic ) )
+                        continue;
+
+                    ++rowVisits;
+                    ++_boundPropagationRowVisits;
+
+                    if ( !tableauChanged && !_rowsThatTighten.exists( basic ) && !rowHasChangedVariables( basic ) )
+                        continue;
+
+                    unsigned previousNumLearnedBounds = numLearnedBounds;
+                    changedVariables.clear();
+                    bool merged = tightenBoundsOnRow( basic, numLearnedBounds, &changedVariables );
+                    enqueueRowsOfVariables( changedVariables, basic, merged );
+
+                    if ( merged )
+                        tableauChanged = true;
+                    else if ( numLearnedBounds > previousNumLearnedBounds )
+                        markRowVariablesChanged( basic );
+                }
             }
         }
+        catch ( ... )
+        {
+            // Put the rest of the batch back at the front of the queue, where propagateBounds()
+            // would have left it
+            Vector<unsigned> rest;
+            while ( !_boundPropagationQueue.empty() )
+            {
+                rest.append( _boundPropagationQueue.peak() );
+                _boundPropagationQueue.pop();
+            }
 
-        timeval end = Time::sampleMicro();
-        _totalTightenAllBoundsTime += Time::timePassed( start, end );
-
-        _boundsTightendByTightenAllBounds += numLearnedBounds;
+            for ( ++next; next < batch.size(); ++next )
+                _boundPropagationQueue.push( batch[next] );
+            for ( unsigned basic : rest )
+                _boundPropagationQueue.push( basic );
 
-        log( Stringf( "tightenAllBounds -- Done. Number of learned bounds: %u\n", numLearnedBounds ) );
+            throw;
+        }
     }
 
-    bool tightenBoundsOnRow( unsigned basic, unsigned &numLearnedBounds )
+    // Whether tightenBoundsOnRow() would learn a bound from this row. Only reads shared state.
+    bool rowTightensBounds( unsigned basic ) const
     {
-        const Tableau::Entry *row = _tableau.getRow( basic );
-        const Tableau::Entry *tighteningVar;
+        RowActivity activity;
+        computeRowActivity( basic, activity );
 
-        while ( row != NULL )
+        ImpliedBound lower;
+        ImpliedBound upper;
+
+        Tableau::Iterator row = _tableau.getRow( basic );
+        while ( !row.atEnd() )
         {
-            tighteningVar = row;
+            unsigned variable = row.getColumn();
+            impliedBounds( activity, variable, row.getValue(), lower, upper );
+            row.advance();
+
+            if ( tightensUpperBound( variable, upper ) || tightensLowerBound( variable, lower ) )
+                return true;
+        }
 
-            row = row->nextInRow();
+        return false;
+    }
+
+    // A learned bound may also have moved the bounds of a ReLU partner
+    void markRowVariablesChanged( unsigned basic )
+    {
+        Tableau::Iterator row = _tableau.getRow( basic );
+        while ( !row.atEnd() )
+        {
+            unsigned variable = row.getColumn();
+            row.advance();
 
-            double scale = -1.0 / tighteningVar->getValue();
+            _variablesChangedInBatch.insert( variable );
+            if ( _reluPairs.isRelu( variable ) )
+                _variablesChangedInBatch.insert( _reluPairs.toPartner( variable ) );
+        }
+    }
 
-            const Tableau::Entry *otherEntry = _tableau.getRow( basic );
-            const Tableau::Entry *current;
-            unsigned column;
+    bool rowHasChangedVariables( unsigned basic ) const
+    {
+        Tableau::Iterator row = _tableau.getRow( basic );
+        while ( !row.atEnd() )
+        {
+            if ( _variablesChangedInBatch.exists( row.getColumn() ) )
+                return true;
+            row.advance();
+        }
 
-            double max = 0.0;
-            double min = 0.0;
-            unsigned minBoundLevel = 0;
-            unsigned maxBoundLevel = 0;
+        return false;
+    }
 
-            while ( otherEntry != NULL )
+    // Queue the rows that contain these variables. After a merge, the visited row may have changed as well.
+    void enqueueRowsOfVariables( Vector<unsigned> &variables, unsigned visitedRow, bool tableauChanged )
+    {
+        for ( unsigned variable : variables )
+        {
+            Tableau::Iterator column = _tableau.getColumn( variable );
+            while ( !column.atEnd() )
             {
-                current = otherEntry;
-                otherEntry = otherEntry->nextInRow();
+                if ( tableauChanged || column.getRow() != visitedRow )
+                    enqueueBoundPropagationRow( column.getRow() );
+                column.advance();
+            }
+        }
+    }
+
+    void clearBoundPropagationQueue()
+    {
+        while ( !_boundPropagationQueue.empty() )
+        {
+            _queuedBoundPropagationRows.erase( _boundPropagationQueue.peak() );
+            _boundPropagationQueue.pop();
+        }
+    }
+
+    void enqueueBoundPropagationRow( unsigned basic )
+    {
+        if ( _queuedBoundPropagationRows.exists( basic ) )
+            return;
+
+        _queuedBoundPropagationRows.insert( basic );
+        _boundPropagationQueue.push( basic );
+    }
+
+    /*
+      Failed-literal probing, called by the SmtCore before it splits. Each phase of up to
+      _reluProbingPairs active pairs (the broken ones first) is assumed in turn, and bounds are
+      propagated from it without touching the tableau. A phase that leads to a lower bound
+      above an upper bound is refuted, and the pair is fixed in its other phase at the current
+      level; if both phases are refuted, so is the current state. Return true if a pair was
+      fixed.
+    */
+    bool probeReluPhases()
+    {
+        if ( _reluProbingPairs == 0 )
+            return false;
+
+        timeval start = Time::sampleMicro();
+        ++_numProbingRounds;
 
-                column = current->getColumn();
-                if ( column == tighteningVar->getColumn() )
+        Vector<unsigned> candidates;
+        Set<unsigned> seen;
+        for ( unsigned b : _brokenReluBs )
+        {
+            if ( candidates.size() >= _reluProbingPairs )
+                break;
+            candidates.append( _reluPairs.bToF( b ) );
+            seen.insert( _reluPairs.bToF( b ) );
+        }
+
+        for ( const auto &pair : _reluPairs.getPairs() )
+        {
+            if ( candidates.size() >= _reluProbingPairs )
+                break;
+            unsigned f = pair.getF();
+            if ( !_dissolvedReluVariables.exists( f ) && !seen.exists( f ) )
+                candidates.append( f );
+        }
+
+        unsigned numFixed = 0;
+        try
+        {
+            for ( unsigned f : candidates )
+            {
+                // Fixing an earlier pair may have dissolved this one
+                if ( _dissolvedReluVariables.exists( f ) )
                     continue;
 
-                double coefficient = current->getValue() * scale;
-                if ( FloatUtils::isPositive( coefficient ) )
+                bool splitRefuted = phaseRefuted( f, TYPE_SPLIT );
+                bool mergeRefuted = phaseRefuted( f, TYPE_MERGE );
+
+                if ( splitRefuted && mergeRefuted )
                 {
-                    // Positive coefficient
-                    min += _lowerBounds[column].getBound() * coefficient;
-                    max += _upperBounds[column].getBound() * coefficient;
-
-                    if ( _lowerBounds[column].getLevel() > minBoundLevel )
-                        minBoundLevel = _lowerBounds[column].getLevel();
-                    if ( _upperBounds[column].getLevel() > maxBoundLevel )
-                        maxBoundLevel = _upperBounds[column].getLevel();
+                    SOLVER_LOG( _log, LOG_RELU, LOG_DEBUG, "Probing refuted both phases of %s\n",
+                                toName( f ).ascii() );
+                    ++_numProbingConflicts;
+                    throw InvariantViolationError( _currentStackDepth );
                 }
+
+                if ( splitRefuted )
+                    updateLowerBound( f, 0.0, _currentStackDepth );
+                else if ( mergeRefuted )
+                    updateUpperBound( f, 0.0, _currentStackDepth );
                 else
-                {
-                    // Negative coefficient
-                    min += _upperBounds[column].getBound() * coefficient;
-                    max += _lowerBounds[column].getBound() * coefficient;
-
-                    if ( _lowerBounds[column].getLevel() > maxBoundLevel )
-                        maxBoundLevel = _lowerBounds[column].getLevel();
-                    if ( _upperBounds[column].getLevel() > minBoundLevel )
-                        minBoundLevel = _upperBounds[column].getLevel();
-                }
+                    continue;
+
+                SOLVER_LOG( _log, LOG_RELU, LOG_DEBUG, "Probing fixed %s in the %s phase\n",
+                            toName( f ).ascii(), splitRefuted ? "merge" : "split" );
+                ++numFixed;
+                ++_numPairsFixedByProbing;
+            }
+        }
+        catch ( ... )
+        {
+            timeval end = Time::sampleMicro();
+            _totalProbingTime += Time::timePassed( start, end );
+            throw;
+        }
+
+        timeval end = Time::sampleMicro();
+        _totalProbingTime += Time::timePassed( start, end );
+
+        return numFixed > 0;
+    }
+
+    // Assume a phase for the pair, and see whether bound propagation finds a conflict
+    bool phaseRefuted( unsigned f, ReluDissolutionType type )
+    {
+        ++_numProbes;
+
+        unsigned b = _reluPairs.fToB( f );
+        bool consistent;
+        if ( type == TYPE_SPLIT )
+            consistent = probeUpperBound( b, 0.0 ) && probeUpperBound( f, 0.0 ) && probeReluPair( f );
+        else
+            consistent = probeLowerBound( b, 0.0 ) && probeReluPair( f );
+
+        unsigned rowVisits = 0;
+        while ( consistent && !_boundPropagationQueue.empty() && rowVisits < RELU_PROBING_MAX_ROW_VISITS )
+        {
+            unsigned basic = _boundPropagationQueue.peak();
+            _boundPropagationQueue.pop();
+            _queuedBoundPropagationRows.erase( basic );
+
+            if ( !_basicVariables.exists( basic ) )
+                continue;
+
+            ++rowVisits;
+            consistent = probeRow( basic );
+        }
+
+        while ( !_boundPropagationQueue.empty() )
+        {
+            _queuedBoundPropagationRows.erase( _boundPropagationQueue.peak() );
+            _boundPropagationQueue.pop();
+        }
+
+        // Restore the bounds, latest change first
+        for ( unsigned i = _probeTrail.size(); i > 0; --i )
+        {
+            const ProbedBound &entry = _probeTrail[i - 1];
+            if ( entry._isUpper )
+                _upperBounds[entry._variable] = entry._bound;
+            else
+                _lowerBounds[entry._variable] = entry._bound;
+        }
+        _probeTrail.clear();
+
+        return !consistent;
+    }
+
+    bool probeRow( unsigned basic )
+    {
+        RowActivity activity;
+        computeRowActivity( basic, activity );
+
+        Tableau::Iterator row = _tableau.getRow( basic );
+        while ( !row.atEnd() )
+        {
+            unsigned variable = row.getColumn();
+            double coefficient = row.getValue();
+            row.advance();
+
+            ImpliedBound lower;
+            ImpliedBound upper;
+            impliedBounds( activity, variable, coefficient, lower, upper );
+
+            bool learned = false;
+            if ( tightensUpperBound( variable, upper ) )
+            {
+                if ( !probeUpperBound( variable, upper._bound ) )
+                    return false;
+                learned = true;
+            }
+
+            if ( tightensLowerBound( variable, lower ) )
+            {
+                if ( !probeLowerBound( variable, lower._bound ) )
+                    return false;
+                learned = true;
             }
 
-            unsigned currentVar = tighteningVar->getColumn();
+            if ( !learned )
+                continue;
+
+            if ( _reluPairs.isRelu( variable ) && !probeReluPair( variable ) )
+                return false;
+
+            computeRowActivity( basic, activity );
+        }
+
+        return true;
+    }
+
+    // Bounds that f = max( 0, b ) implies, whether or not the pair is dissolved
+    bool probeReluPair( unsigned variable )
+    {
+        unsigned f = _reluPairs.isF( variable ) ? variable : _reluPairs.toPartner( variable );
+        unsigned b = _reluPairs.fToB( f );
+
+        if ( _lowerBounds[b].finite() && !probeLowerBound( f, _lowerBounds[b].getBound() ) )
+            return false;
+        if ( _upperBounds[b].finite() && !probeUpperBound( f, FloatUtils::max( _upperBounds[b].getBound(), 0.0 ) ) )
+            return false;
+        if ( _upperBounds[f].finite() && !probeUpperBound( b, _upperBounds[f].getBound() ) )
+            return false;
+        if ( _lowerBounds[f].finite() && FloatUtils::isPositive( _lowerBounds[f].getBound() ) &&
+             !probeLowerBound( b, _lowerBounds[f].getBound() ) )
+            return false;
+
+        return true;
+    }
+
+    // Tighten a bound for the current probe. Return false if it crosses the other bound.
+    bool probeUpperBound( unsigned variable, double bound )
+    {
+        if ( _upperBounds[variable].finite() && !FloatUtils::lt( bound, _upperBounds[variable].getBound() ) )
+            return true;
+
+        ProbedBound entry;
+        entry._variable = variable;
+        entry._isUpper = true;
+        entry._bound = _upperBounds[variable];
+        _probeTrail.append( entry );
+
+        _upperBounds[variable].setBound( bound );
+        if ( _lowerBounds[variable].finite() && !FloatUtils::lte( _lowerBounds[variable].getBound(), bound ) )
+            return false;
+
+        if ( boundImproved( entry._bound, _upperBounds[variable] ) )
+            enqueueRowsOfVariable( variable );
+        return true;
+    }
+
+    bool probeLowerBound( unsigned variable, double bound )
+    {
+        if ( _lowerBounds[variable].finite() && !FloatUtils::gt( bound, _lowerBounds[variable].getBound() ) )
+            return true;
+
+        ProbedBound entry;
+        entry._variable = variable;
+        entry._isUpper = false;
+        entry._bound = _lowerBounds[variable];
+        _probeTrail.append( entry );
+
+        _lowerBounds[variable].setBound( bound );
+        if ( _upperBounds[variable].finite() && !FloatUtils::lte( bound, _upperBounds[variable].getBound() ) )
+            return false;
+
+        if ( boundImproved( entry._bound, _lowerBounds[variable] ) )
+            enqueueRowsOfVariable( variable );
+        return true;
+    }
+
+    void enqueueRowsOfVariable( unsigned variable )
+    {
+        Tableau::Iterator column = _tableau.getColumn( variable );
+        while ( !column.atEnd() )
+        {
+            enqueueBoundPropagationRow( column.getRow() );
+            column.advance();
+        }
+    }
+
+    bool boundImproved( const VariableBound &previous, const VariableBound &current ) const
+    {
+        if ( !previous.finite() )
+            return true;
+
+        return FloatUtils::gt( fabs( current.getBound() - previous.getBound() ), _boundPropagationMinImprovement );
+    }
+
+    /*
+      Derive bounds for the variables of the row. If changedVariables is given, variables whose
+      bounds improved by more than the minimal improvement are added to it.
+    */
+    bool tightenBoundsOnRow( unsigned basic, unsigned &numLearnedBounds, Vector<unsigned> *changedVariables = NULL )
+    {
+        // Each variable's implied bounds are the row's activity minus its own contribution
+        RowActivity activity;
+        computeRowActivity( basic, activity );
+
+        Tableau::Iterator row = _tableau.getRow( basic );
+        Tableau::Iterator tighteningVar;
+
+        while ( !row.atEnd() )
+        {
+            tighteningVar = row;
+
+            row.advance();
+
+            unsigned currentVar = tighteningVar.getColumn();
+
+            ImpliedBound lower;
+            ImpliedBound upper;
+            impliedBounds( activity, currentVar, tighteningVar.getValue(), lower, upper );
 
-            if ( FloatUtils::lt( max, _upperBounds[currentVar].getBound() ) )
+            VariableBound previousUpperBound = _upperBounds[currentVar];
+            VariableBound previousLowerBound = _lowerBounds[currentVar];
+            bool learned = false;
+
+            if ( tightensUpperBound( currentVar, upper ) )
             {
                 // Found an UB
                 ++numLearnedBounds;
-                updateUpperBound( currentVar, max, maxBoundLevel );
+                updateUpperBound( currentVar, upper._bound, upper._level, upper._decisions );
+                learned = true;
             }
 
-            if ( FloatUtils::gt( min, _lowerBounds[currentVar].getBound() ) )
+            if ( tightensLowerBound( currentVar, lower ) )
             {
                 // Found a LB
                 ++numLearnedBounds;
                 // Tableau changed, need to restart
-                if ( updateLowerBound( currentVar, min, minBoundLevel ) )
+                if ( updateLowerBound( currentVar, lower._bound, lower._level, lower._decisions ) )
+                {
+                    // The pair was merged: b's column went into f's, and both bounds moved
+                    if ( changedVariables )
+                    {
+                        changedVariables->append( currentVar );
+                        changedVariables->append( _reluPairs.toPartner( currentVar ) );
+                    }
                     return true;
+                }
+                learned = true;
+            }
+
+            if ( !learned )
+                continue;
+
+            // A new bound may also have changed the bounds of a ReLU partner on this row
+            computeRowActivity( basic, activity );
+
+            if ( changedVariables &&
+                 ( boundImproved( previousUpperBound, _upperBounds[currentVar] ) ||
+                   boundImproved( previousLowerBound, _lowerBounds[currentVar] ) ) )
+            {
+                changedVariables->append( currentVar );
+                if ( _reluPairs.isRelu( currentVar ) )
+                    changedVariables->append( _reluPairs.toPartner( currentVar ) );
             }
         }
 
@@ -3762,6 +5086,115 @@ public:
         return false;
     }
 
+    // The bounds that the rest of the row implies on one of its variables
+    void impliedBounds( const RowActivity &activity, unsigned variable, double coefficient,
+                        ImpliedBound &lower, ImpliedBound &upper ) const
+    {
+        double scale = -1.0 / coefficient;
+
+        // With a negative scale, the smallest activity of the rest of the row gives the largest value
+        RowActivity::Side lowerSide = ( scale > 0 ) ? RowActivity::LOW : RowActivity::HIGH;
+        RowActivity::Side upperSide = ( scale > 0 ) ? RowActivity::HIGH : RowActivity::LOW;
+
+        lower._finite = activityWithoutVariable( activity, lowerSide, variable, coefficient,
+                                                 lower._bound, lower._level, lower._decisions );
+        upper._finite = activityWithoutVariable( activity, upperSide, variable, coefficient,
+                                                 upper._bound, upper._level, upper._decisions );
+        lower._bound *= scale;
+        upper._bound *= scale;
+    }
+
+    bool tightensUpperBound( unsigned variable, const ImpliedBound &upper ) const
+    {
+        return upper._finite &&
+            ( !_upperBounds[variable].finite() || FloatUtils::lt( upper._bound, _upperBounds[variable].getBound() ) );
+    }
+
+    bool tightensLowerBound( unsigned variable, const ImpliedBound &lower ) const
+    {
+        return lower._finite &&
+            ( !_lowerBounds[variable].finite() || FloatUtils::gt( lower._bound, _lowerBounds[variable].getBound() ) );
+    }
+
+    const VariableBound &contributingBound( RowActivity::Side side, unsigned variable, double coefficient ) const
+    {
+        if ( ( coefficient > 0 ) == ( side == RowActivity::LOW ) )
+            return _lowerBounds[variable];
+        return _upperBounds[variable];
+    }
+
+    void computeRowActivity( unsigned basic, RowActivity &activity ) const
+    {
+        for ( unsigned side = RowActivity::LOW; side <= RowActivity::HIGH; ++side )
+        {
+            activity._sum[side] = 0.0;
+            activity._numInfinite[side] = 0;
+            activity._topLevel[side] = 0;
+            activity._topLevelVariable[side] = _numVariables;
+            activity._secondLevel[side] = 0;
+            activity._decisions[side] = 0;
+            activity._sharedDecisions[side] = 0;
+        }
+
+        Tableau::Iterator row = _tableau.getRow( basic );
+        while ( !row.atEnd() )
+        {
+            unsigned column = row.getColumn();
+            double coefficient = row.getValue();
+            row.advance();
+
+            for ( unsigned side = RowActivity::LOW; side <= RowActivity::HIGH; ++side )
+            {
+                const VariableBound &bound = contributingBound( (RowActivity::Side)side, column, coefficient );
+
+                if ( bound.finite() )
+                    activity._sum[side] += bound.getBound() * coefficient;
+                else
+                    ++activity._numInfinite[side];
+
+                DecisionSet decisions = bound.getDecisions();
+                activity._sharedDecisions[side] |= activity._decisions[side] & decisions;
+                activity._decisions[side] |= decisions;
+
+                unsigned level = bound.getLevel();
+                if ( level > activity._topLevel[side] )
+                {
+                    activity._secondLevel[side] = activity._topLevel[side];
+                    activity._topLevel[side] = level;
+                    activity._topLevelVariable[side] = column;
+                }
+                else if ( level > activity._secondLevel[side] )
+                {
+                    activity._secondLevel[side] = level;
+                }
+            }
+        }
+    }
+
+    // Returns false if the rest of the row has an infinite contribution on this side
+    bool activityWithoutVariable( const RowActivity &activity, RowActivity::Side side, unsigned variable,
+                                  double coefficient, double &sum, unsigned &level,
+                                  DecisionSet &decisions ) const
+    {
+        const VariableBound &bound = contributingBound( side, variable, coefficient );
+
+        sum = activity._sum[side];
+        unsigned numInfinite = activity._numInfinite[side];
+        if ( bound.finite() )
+            sum -= bound.getBound() * coefficient;
+        else
+            --numInfinite;
+
+        level = ( activity._topLevelVariable[side] == variable ) ?
+            activity._secondLevel[side] : activity._topLevel[side];
+
+        // The variable's own decisions stay only if another bound on this side depends on them
+        DecisionSet own = bound.getDecisions();
+        decisions = ( activity._decisions[side] & ~own ) | ( activity._sharedDecisions[side] & own );
+
+        return numInfinite == 0;
+    }
+
     void adjustGlpkAssignment( Map<unsigned, double> &assignment )
     {
         for ( auto &pair : assignment )
@@ -3798,22 +5231,22 @@ public:
     {
         double result = 0.0;
 
-        const Tableau::Entry *rowEntry = _tableau.getRow( basic );
-        const Tableau::Entry *current;
+        Tableau::Iterator rowEntry = _tableau.getRow( basic );
+        Tableau::Iterator current;
 
-        while ( rowEntry != NULL )
+        while ( !rowEntry.atEnd() )
         {
             current = rowEntry;
-            rowEntry = rowEntry->nextInRow();
+            rowEntry.advance();
 
-            unsigned column = current->getColumn();
+            unsigned column = current.getColumn();
 
             if ( column != basic )
-                result += assignment[column] * current->getValue();
+                result += assignment[column] * current.getValue();
             else
-                if ( FloatUtils::areDisequal( current->getValue(), -1.0 ) )
+                if ( FloatUtils::areDisequal( current.getValue(), -1.0 ) )
                 {
-                    printf( "Error! Basic's coefficient is not -1. It is: %lf\n", current->getValue() );
+                    printf( "Error! Basic's coefficient is not -1. It is: %lf\n", current.getValue() );
                     exit( 2 );
                 }
         }
@@ -3843,18 +5276,18 @@ public:
     {
         double result = 0.0;
 
-        const Tableau::Entry *rowEntry = _tableau.getRow( basic );
-        const Tableau::Entry *current;
+        Tableau::Iterator rowEntry = _tableau.getRow( basic );
+        Tableau::Iterator current;
 
-        while ( rowEntry != NULL )
+        while ( !rowEntry.atEnd() )
         {
             current = rowEntry;
-            rowEntry = rowEntry->nextInRow();
+            rowEntry.advance();
 
-            unsigned column = current->getColumn();
+            unsigned column = current.getColumn();
 
             if ( column != basic )
-                result += _assignment[column] * current->getValue();
+                result += _assignment[column] * current.getValue();
         }
 
         if ( FloatUtils::isZero( result ) )
@@ -3889,15 +5322,15 @@ public:
     {
         double result = 0.0;
 
-        const Tableau::Entry *rowEntry = _preprocessedTableau.getRow( variable );
-        const Tableau::Entry *current;
+        Tableau::Iterator rowEntry = _preprocessedTableau.getRow( variable );
+        Tableau::Iterator current;
 
-        while ( rowEntry != NULL )
+        while ( !rowEntry.atEnd() )
         {
             current = rowEntry;
-            rowEntry = rowEntry->nextInRow();
+            rowEntry.advance();
 
-            unsigned column = current->getColumn();
+            unsigned column = current.getColumn();
 
             if ( column != variable )
             {
@@ -3910,7 +5343,7 @@ public:
                         adjustedColumn = _reluPairs.toPartner( column );
                 }
 
-                result += _assignment[adjustedColumn] * current->getValue();
+                result += _assignment[adjustedColumn] * current.getValue();
             }
         }
 
@@ -3925,24 +5358,24 @@ public:
     }
 };
 
-void boundCalculationHook( int n, int m, int *head, int leavingBasic, int enteringNonBasic, double *basicRow )
+void boundCalculationHook( void *info, int n, int m, int *head, int leavingBasic, int enteringNonBasic, double *basicRow )
 {
-    activeReluplex->storeGlpkBoundTightening( n, m, head, leavingBasic, enteringNonBasic, basicRow );
+    ( (Reluplex *)info )->storeGlpkBoundTightening( n, m, head, leavingBasic, enteringNonBasic, basicRow );
 }
 
-void iterationCountCallback( int count )
+void iterationCountCallback( void *info, int count )
 {
-    activeReluplex->glpkIterationCountCallback( count );
+    ( (Reluplex *)info )->glpkIterationCountCallback( count );
 }
 
-void reportSoiCallback( double soi )
+void reportSoiCallback( void *info, double soi )
 {
-    activeReluplex->glpkReportSoi( soi );
+    ( (Reluplex *)info )->glpkReportSoi( soi );
 }
 
-int makeReluAdjustmentsCallback( int n, int m, int nonBasicEncoding, const int *head, const char *flags )
+int makeReluAdjustmentsCallback( void *info, int n, int m, int nonBasicEncoding, const int *head, const char *flags )
 {
-    return activeReluplex->fixRelusInGlpkAssignment( n, m, nonBasicEncoding, head, flags );
+    return ( (Reluplex *)info )->fixRelusInGlpkAssignment( n, m, nonBasicEncoding, head, flags );
 }
 
 #endif // __Reluplex_h__
@@ -49,6 +49,7 @@ LOCAL_INCLUDES += \
 
 CFLAGS += \
 	-MMD \
+	-pthread \
 	-Wall \
 	-Wextra \
 	-Werror \
@@ -58,6 +59,56 @@ CFLAGS += \
 	\
 	-g \
 
+# Build with "make COMPRESSED_TABLEAU=1" to use the compressed tableau storage
+ifdef COMPRESSED_TABLEAU
+CFLAGS += -DCOMPRESSED_TABLEAU
+endif
+
+# Build with "make PIVOT_THREADS=<n>" to eliminate large pivot columns with n threads
+ifdef PIVOT_THREADS
+CFLAGS += -DPIVOT_THREADS=$(PIVOT_THREADS)
+endif
+
+# Build with "make TIGHTENING_THREADS=<n>" to evaluate bound tightening rows with n threads
+ifdef TIGHTENING_THREADS
+CFLAGS += -DTIGHTENING_THREADS=$(TIGHTENING_THREADS)
+endif
+
+# Build with "make SYMBOLIC_BOUND_TIGHTENING=1" to recompute neuron bounds symbolically after every split, merge and pop
+ifdef SYMBOLIC_BOUND_TIGHTENING
+CFLAGS += -DSYMBOLIC_BOUND_TIGHTENING=$(SYMBOLIC_BOUND_TIGHTENING)
+endif
+
+# Build with "make LP_TIGHTENING_THREADS=<n>" to optimize neuron bounds with LPs before solving, on n threads
+ifdef LP_TIGHTENING_THREADS
+CFLAGS += -DLP_TIGHTENING_THREADS=$(LP_TIGHTENING_THREADS)
+endif
+
+# Build with "make BRANCHING_HEURISTIC=<n>" to pick split pairs with heuristic n (see BranchingHeuristics.h)
+ifdef BRANCHING_HEURISTIC
+CFLAGS += -DBRANCHING_HEURISTIC=$(BRANCHING_HEURISTIC)
+endif
+
+# Build with "make NOGOOD_LEARNING=0" to stop learning nogoods from conflicts (see NogoodDatabase.h)
+ifdef NOGOOD_LEARNING
+CFLAGS += -DNOGOOD_LEARNING=$(NOGOOD_LEARNING)
+endif
+
+# Build with "make RESTART_POLICY=<n>" to restart the search with policy n (see SmtCore.h)
+ifdef RESTART_POLICY
+CFLAGS += -DRESTART_POLICY=$(RESTART_POLICY)
+endif
+
+# Build with "make RELU_PROBING=<n>" to probe the phases of up to n ReLU pairs before every split
+ifdef RELU_PROBING
+CFLAGS += -DRELU_PROBING=$(RELU_PROBING)
+endif
+
+# Build with "make MAX_LOG_LEVEL=<n>" to compile out log messages above level n (see SolverLog.h)
+ifdef MAX_LOG_LEVEL
+CFLAGS += -DSOLVER_LOG_MAX_LEVEL=$(MAX_LOG_LEVEL)
+endif
+
 %.obj: %.cpp
 	$(COMPILE) -c -o $@ $< $(CFLAGS) $(addprefix -I, $(LOCAL_INCLUDES))
 
@@ -66,6 +117,7 @@ CFLAGS += \
 #
 
 SYSTEM_LIBRARIES += \
+	pthread \
 
 LOCAL_LIBRARIES += \
 
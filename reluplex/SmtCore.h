@@ -13,19 +13,61 @@
 #ifndef __SmtCore_h__
 #define __SmtCore_h__
 
+#include "BranchingHeuristics.h"
 #include "IReluplex.h"
 #include "Stack.h"
 #include "MStringf.h"
+#include "NogoodDatabase.h"
+#include "SolverLog.h"
 #include "Tableau.h"
 #include "TimeUtils.h"
 #include "VariableBound.h"
+#include "Vector.h"
 
 // The number of times a ReLU pair can be corrected before a split occurs.
 static const unsigned NUM_RELU_OPERATIONS_BEFORE_SPLIT = 5;
 
+// The pair to split on (see BranchingHeuristics.h). Build with BRANCHING_HEURISTIC=<n> to
+// change the default.
+#ifdef BRANCHING_HEURISTIC
+static const BranchingHeuristic::Type DEFAULT_BRANCHING_HEURISTIC = (BranchingHeuristic::Type)BRANCHING_HEURISTIC;
+#else
+static const BranchingHeuristic::Type DEFAULT_BRANCHING_HEURISTIC = BranchingHeuristic::REPEATEDLY_BROKEN;
+#endif
+
+// Learn a nogood from every conflict and propagate the learned nogoods. Build with
+// NOGOOD_LEARNING=0 to change the default.
+#ifdef NOGOOD_LEARNING
+static const bool DEFAULT_NOGOOD_LEARNING = NOGOOD_LEARNING;
+#else
+static const bool DEFAULT_NOGOOD_LEARNING = true;
+#endif
+
+// When to restart the search (see SmtCore::RestartPolicy). Build with RESTART_POLICY=<n> to
+// change the default.
+#ifdef RESTART_POLICY
+static const unsigned DEFAULT_RESTART_POLICY = RESTART_POLICY;
+#else
+static const unsigned DEFAULT_RESTART_POLICY = 0;
+#endif
+
+// Luby restarts happen after this many conflicts times the next element of the Luby sequence
+static const unsigned LUBY_RESTART_UNIT = 16;
+
+// Geometric restarts happen after this many conflicts, growing by the factor after every restart
+static const unsigned GEOMETRIC_RESTART_FIRST_INTERVAL = 32;
+static const double GEOMETRIC_RESTART_FACTOR = 1.5;
+static const unsigned MAX_RESTART_INTERVAL = 1000000000;
+
 class SmtCore
 {
 public:
+    enum RestartPolicy {
+        NO_RESTARTS = 0,
+        LUBY_RESTARTS = 1,
+        GEOMETRIC_RESTARTS = 2,
+    };
+
     class SplitInformation
     {
     public:
@@ -34,8 +76,16 @@ public:
             MERGING_RELU = 1,
         };
 
-        SplitInformation( unsigned numVariables ) : _tableau( numVariables )
+        SplitInformation( unsigned numVariables, Tableau::StorageType storageType )
+            : _assignment( new double[numVariables] )
+            , _basicVariables( numVariables )
+            , _tableau( numVariables, storageType )
+        {
+        }
+
+        ~SplitInformation()
         {
+            delete []_assignment;
         }
 
         Type _type;
@@ -44,29 +94,133 @@ public:
 
         bool _firstAttempt;
 
-        List<VariableBound> _lowerBounds;
-        List<VariableBound> _upperBounds;
-        List<double> _assignment;
-        Map<unsigned, IReluplex::ReluDissolutionType> _dissolvedReluPairs;
-        Set<unsigned> _basicVariables;
+        // Bounds and dissolved pairs are restored by undoing the trail back to this size
+        unsigned _trailSize;
+
+        double *_assignment;
+        IndexSet _basicVariables;
         Tableau _tableau;
     };
 
-    SmtCore( IReluplex *reluplex, unsigned numVariables )
+    SmtCore( IReluplex *reluplex, unsigned numVariables, SolverLog *log )
         : _reluplex( reluplex )
         , _numVariables( numVariables )
         , _totalSmtCoreTimeMilli( 0 )
-        , _logging( false )
+        , _log( log )
+        , _branchingHeuristic( BranchingHeuristic::create( DEFAULT_BRANCHING_HEURISTIC ) )
+        , _numHeuristicChoices( 0 )
+        , _nogoods( reluplex )
+        , _useNogoods( DEFAULT_NOGOOD_LEARNING )
+        , _numNogoodsLearned( 0 )
+        , _numNogoodPropagations( 0 )
+        , _numNogoodConflicts( 0 )
+        , _restartPolicy( NO_RESTARTS )
+        , _numRestarts( 0 )
+        , _conflictsSinceRestart( 0 )
+        , _conflictsBeforeRestart( 0 )
+        , _numLevelZeroBoundsKept( 0 )
     {
+        setRestartPolicy( (RestartPolicy)DEFAULT_RESTART_POLICY );
     }
 
     ~SmtCore()
     {
         while ( !_stack.empty() )
+            delete _stack.pop();
+
+        while ( !_recycledStates.empty() )
         {
-            delete _stack.top();
-            _stack.pop();
+            delete _recycledStates.top();
+            _recycledStates.pop();
         }
+
+        delete _branchingHeuristic;
+    }
+
+    void setBranchingHeuristic( BranchingHeuristic::Type type )
+    {
+        BranchingHeuristic *branchingHeuristic = BranchingHeuristic::create( type );
+        delete _branchingHeuristic;
+        _branchingHeuristic = branchingHeuristic;
+    }
+
+    const BranchingHeuristic *getBranchingHeuristic() const
+    {
+        return _branchingHeuristic;
+    }
+
+    // The number of splits on a pair other than the one that reached the limit
+    unsigned getNumHeuristicChoices() const
+    {
+        return _numHeuristicChoices;
+    }
+
+    void toggleNogoodLearning( bool value )
+    {
+        _useNogoods = value;
+    }
+
+    bool getNogoodLearning() const
+    {
+        return _useNogoods;
+    }
+
+    unsigned getNumNogoodsLearned() const
+    {
+        return _numNogoodsLearned;
+    }
+
+    unsigned getNumNogoodsDropped() const
+    {
+        return _nogoods.getNumDropped();
+    }
+
+    unsigned getNumNogoodPropagations() const
+    {
+        return _numNogoodPropagations;
+    }
+
+    unsigned getNumNogoodConflicts() const
+    {
+        return _numNogoodConflicts;
+    }
+
+    void setRestartPolicy( RestartPolicy policy )
+    {
+        if ( policy != NO_RESTARTS && policy != LUBY_RESTARTS && policy != GEOMETRIC_RESTARTS )
+            throw Error( Error::UNKNOWN_RESTART_POLICY, Stringf( "Policy: %u", policy ).ascii() );
+
+        _restartPolicy = policy;
+        _conflictsSinceRestart = 0;
+        _conflictsBeforeRestart = restartInterval( _numRestarts );
+    }
+
+    RestartPolicy getRestartPolicy() const
+    {
+        return _restartPolicy;
+    }
+
+    const char *getRestartPolicyName() const
+    {
+        switch ( _restartPolicy )
+        {
+        case LUBY_RESTARTS:
+            return "Luby";
+        case GEOMETRIC_RESTARTS:
+            return "geometric";
+        default:
+            return "none";
+        }
+    }
+
+    unsigned getNumRestarts() const
+    {
+        return _numRestarts;
+    }
+
+    unsigned getNumLevelZeroBoundsKept() const
+    {
+        return _numLevelZeroBoundsKept;
     }
 
     unsigned long long getSmtCoreTime() const
@@ -74,39 +228,29 @@ public:
         return _totalSmtCoreTimeMilli;
     }
 
+    unsigned getStackDepth() const
+    {
+        return _stack.size();
+    }
+
     void storeCurrentState( SplitInformation *splitInformation, unsigned variable )
     {
         splitInformation->_variable = variable;
 
-        // Store current bounds
-        const VariableBound *lowerBounds = _reluplex->getLowerBounds();
-        const VariableBound *upperBounds = _reluplex->getUpperBounds();
-        for ( unsigned i = 0; i < _numVariables; ++i )
-        {
-            splitInformation->_lowerBounds.append( lowerBounds[i] );
-            splitInformation->_upperBounds.append( upperBounds[i] );
-        }
-
-        // Store current dissolved pairs
-        splitInformation->_dissolvedReluPairs = _reluplex->getDissolvedReluPairs();
+        // Bound changes and dissolved pairs are recorded on the trail from this point on
+        splitInformation->_trailSize = _reluplex->getTrailSize();
 
-        // Store basic variables, assignment and reluplex
+        // Store basic variables, assignment and reluplex. These are rewritten wholesale by
+        // the LP solver, so a snapshot is cheaper than recording every change.
         splitInformation->_basicVariables = _reluplex->getBasicVariables();
-
-        const double *assignment = _reluplex->getAssignment();
-        for ( unsigned i = 0; i < _numVariables; ++i )
-            splitInformation->_assignment.append( assignment[i] );
+        memcpy( splitInformation->_assignment, _reluplex->getAssignment(), sizeof(double) * _numVariables );
         _reluplex->backupIntoMatrix( &(splitInformation->_tableau) );
     }
 
     void restorePreviousState( SplitInformation *previousState )
     {
-        // Undo bounds as a result of the pop.
-        _reluplex->setLowerBounds( previousState->_lowerBounds );
-        _reluplex->setUpperBounds( previousState->_upperBounds );
-
-        // Restore dissolved relu pairs
-        _reluplex->setDissolvedReluPairs( previousState->_dissolvedReluPairs );
+        // Undo bounds and dissolved relu pairs as a result of the pop.
+        _reluplex->undoTrail( previousState->_trailSize );
 
         // Undo the reluplex, assignment and basic variables
         _reluplex->setBasicVariables( previousState->_basicVariables );
@@ -119,33 +263,41 @@ public:
     bool beginWithSplit( unsigned f )
     {
         // Return true for split, false for merge.
+
+        // When restarting, go back to the phase the pair was last given
+        if ( _restartPolicy != NO_RESTARTS && _savedPhases.exists( f ) )
+        {
+            SOLVER_LOG( *_log, LOG_SMT, LOG_DEBUG, "Starting with the saved phase\n" );
+            return _savedPhases[f] == SplitInformation::SPLITTING_RELU;
+        }
+
         // Decide according to current assignment (this is the F variable).
 
         double assignment = _reluplex->getAssignment()[f];
 
         if ( FloatUtils::isPositive( assignment ) )
         {
-            log( "Starting with merge\n" );
+            SOLVER_LOG( *_log, LOG_SMT, LOG_DEBUG, "Starting with merge\n" );
             // If F is currently positive, we want a merge
             return false;
         }
 
-        log( "Starting with split\n" );
+        SOLVER_LOG( *_log, LOG_SMT, LOG_DEBUG, "Starting with split\n" );
         // F is zero, so we want a split.
         return true;
     }
 
     void dissolveReluOnVar( unsigned variable )
     {
-        log( Stringf( "Resolving relu on var: %s. (current depth = %u)\n",
-                      _reluplex->toName( variable ).ascii(), _stack.size() ) );
+        SOLVER_LOG( *_log, LOG_SMT, LOG_DEBUG, "Resolving relu on var: %s. (current depth = %u)\n",
+                    _reluplex->toName( variable ).ascii(), _stack.size() );
 
-        log( Stringf( "Column size of %s when dissolving: %u\n",
-                      _reluplex->toName( variable ).ascii(),
-                      _reluplex->getColumnSize( variable ) ) );
+        SOLVER_LOG( *_log, LOG_SMT, LOG_DEBUG, "Column size of %s when dissolving: %u\n",
+                    _reluplex->toName( variable ).ascii(),
+                    _reluplex->getColumnSize( variable ) );
 
         // Store the current state in splitInformation
-        SplitInformation *splitInformation = new SplitInformation( _numVariables );
+        SplitInformation *splitInformation = allocateSplitInformation();
 
         storeCurrentState( splitInformation, variable );
 
@@ -157,10 +309,10 @@ public:
             // Do a split
             splitInformation->_type = SplitInformation::SPLITTING_RELU;
             _reluplex->incNumSplits();
-            _stack.push( splitInformation );
+            _stack.append( splitInformation );
 
             // Adjust upper bounds
-            _reluplex->updateUpperBound( variable, 0.0, _stack.size() );
+            _reluplex->updateUpperBound( variable, 0.0, _stack.size(), decisionAtLevel( _stack.size() ) );
         }
         else
         {
@@ -168,12 +320,14 @@ public:
             splitInformation->_type = SmtCore::SplitInformation::MERGING_RELU;
             _reluplex->incNumMerges();
 
-            _stack.push( splitInformation );
+            _stack.append( splitInformation );
 
             // Adjust lower bounds
-            _reluplex->updateLowerBound( variable, 0.0, _stack.size() );
+            _reluplex->updateLowerBound( variable, 0.0, _stack.size(), decisionAtLevel( _stack.size() ) );
         }
 
+        _savedPhases[variable] = splitInformation->_type;
+
         _reluplex->incNumStackVisitedStates();
         _reluplex->setCurrentStackDepth( _stack.size() );
     }
@@ -198,6 +352,9 @@ public:
     {
         timeval start = Time::sampleMicro();
 
+        // Whatever was waiting to be propagated is about to be undone
+        _pendingLiterals.clear();
+
         while ( true )
         {
             if ( _stack.empty() )
@@ -207,48 +364,52 @@ public:
                 throw Error( Error::STACK_IS_EMPTY, "Stack is empty" );
             }
 
-            SmtCore::SplitInformation *oldState = _stack.top();
-            _stack.pop();
+            SmtCore::SplitInformation *oldState = _stack.pop();
 
-            log( Stringf( "popping (variable = %s)\n", _reluplex->toName( oldState->_variable ).ascii() ) );
+            SOLVER_LOG( *_log, LOG_SMT, LOG_DEBUG, "popping (variable = %s)\n", _reluplex->toName( oldState->_variable ).ascii() );
 
             restorePreviousState( oldState );
 
             if ( oldState->_firstAttempt )
             {
                 oldState->_firstAttempt = false;
+                _branchingHeuristic->notifyConflict( oldState->_variable );
 
                 if ( oldState->_type == SmtCore::SplitInformation::SPLITTING_RELU )
                 {
                     // Earlier round was a split. Now comes the merge.
 
-                    log( "Popped a split, now doing a merge\n" );
-                    log( Stringf( "Column size of %s when doing the merge: %u\n",
-                                  _reluplex->toName( oldState->_variable ).ascii(),
-                                  _reluplex->getColumnSize( oldState->_variable ) ) );
+                    SOLVER_LOG( *_log, LOG_SMT, LOG_DEBUG, "Popped a split, now doing a merge\n" );
+                    SOLVER_LOG( *_log, LOG_SMT, LOG_DEBUG, "Column size of %s when doing the merge: %u\n",
+                                _reluplex->toName( oldState->_variable ).ascii(),
+                                _reluplex->getColumnSize( oldState->_variable ) );
 
                     oldState->_type = SmtCore::SplitInformation::MERGING_RELU;
-                    _stack.push( oldState );
+                    _stack.append( oldState );
 
                     // Adjust lower bounds
-                    _reluplex->updateLowerBound( oldState->_variable, 0.0, _stack.size() );
+                    _reluplex->updateLowerBound( oldState->_variable, 0.0, _stack.size(),
+                                                 decisionAtLevel( _stack.size() ) );
                     _reluplex->incNumMerges();
                     _reluplex->computeVariableStatus();
                 }
                 else
                 {
                     // Earlier round was a merge. Now comes the split.
-                    log( "Popped a merge, now doing a split\n" );
+                    SOLVER_LOG( *_log, LOG_SMT, LOG_DEBUG, "Popped a merge, now doing a split\n" );
 
                     oldState->_type = SmtCore::SplitInformation::SPLITTING_RELU;
-                    _stack.push( oldState );
+                    _stack.append( oldState );
 
                     // Adjust upper bounds
-                    _reluplex->updateUpperBound( oldState->_variable, 0.0, _stack.size() );
+                    _reluplex->updateUpperBound( oldState->_variable, 0.0, _stack.size(),
+                                                 decisionAtLevel( _stack.size() ) );
                     _reluplex->incNumSplits();
                     _reluplex->computeVariableStatus();
                 }
 
+                _savedPhases[oldState->_variable] = oldState->_type;
+
                 _reluplex->incNumStackVisitedStates();
                 _reluplex->setMinStackSecondPhase( _stack.size() );
 
@@ -262,9 +423,9 @@ public:
                   _currentlyInStack.erase( oldState->_variable );
                   );
 
-            log( Stringf( "\t\tAfter popping a MERGE, depth = %u\n", _stack.size() ) );
+            SOLVER_LOG( *_log, LOG_SMT, LOG_DEBUG, "\t\tAfter popping a MERGE, depth = %u\n", _stack.size() );
 
-            delete oldState;
+            releaseSplitInformation( oldState );
             oldState = NULL;
 
             _reluplex->incNumPops();
@@ -280,9 +441,32 @@ public:
             _fToViolations[f] = 0;
 
         ++_fToViolations[f];
+        _branchingHeuristic->notifyBrokenRelu( f );
 
         if ( _fToViolations[f] >= NUM_RELU_OPERATIONS_BEFORE_SPLIT )
         {
+            // Probing may fix pairs in place of a split
+            if ( _reluplex->probeReluPhases() )
+            {
+                _fToViolations.clear();
+
+                timeval end = Time::sampleMicro();
+                _totalSmtCoreTimeMilli += Time::timePassed( start, end );
+
+                return true;
+            }
+
+            unsigned splitVariable = _branchingHeuristic->pickSplitVariable( _reluplex, f );
+            if ( splitVariable != f )
+            {
+                SOLVER_LOG( *_log, LOG_SMT, LOG_DEBUG, "Heuristic (%s) picked %s instead of %s\n",
+                            _branchingHeuristic->getName(),
+                            _reluplex->toName( splitVariable ).ascii(),
+                            _reluplex->toName( f ).ascii() );
+                ++_numHeuristicChoices;
+                f = splitVariable;
+            }
+
             DEBUG(
                   if ( _currentlyInStack.exists( f ) )
                   {
@@ -307,24 +491,264 @@ public:
         return false;
     }
 
+    // Called after every conflict, once the SmtCore has popped
+    void notifyConflict()
+    {
+        ++_conflictsSinceRestart;
+    }
+
+    bool restartDue() const
+    {
+        return _restartPolicy != NO_RESTARTS && !_stack.empty() &&
+            _conflictsSinceRestart >= _conflictsBeforeRestart;
+    }
+
+    /*
+      Pop every decision, back to the state before the first split. Bounds that hold at level 0
+      are kept even if they were found deeper in the stack, and so are the saved phases, the
+      learned nogoods and the branching heuristic's scores.
+    */
+    void restart()
+    {
+        timeval start = Time::sampleMicro();
+
+        SOLVER_LOG( *_log, LOG_SMT, LOG_DEBUG, "Restarting after %u conflicts (depth = %u)\n",
+                    _conflictsSinceRestart, _stack.size() );
+
+        // Collect the level 0 bounds before the trail undoes them
+        List<LevelZeroBound> levelZeroBounds;
+        const VariableBound *lowerBounds = _reluplex->getLowerBounds();
+        const VariableBound *upperBounds = _reluplex->getUpperBounds();
+        for ( unsigned i = 0; i < _numVariables; ++i )
+        {
+            if ( lowerBounds[i].finite() && lowerBounds[i].getLevel() == 0 )
+                levelZeroBounds.append( LevelZeroBound( i, lowerBounds[i].getBound(), false ) );
+            if ( upperBounds[i].finite() && upperBounds[i].getLevel() == 0 )
+                levelZeroBounds.append( LevelZeroBound( i, upperBounds[i].getBound(), true ) );
+        }
+
+        _pendingLiterals.clear();
+        restorePreviousState( _stack.get( 0 ) );
+        while ( !_stack.empty() )
+            releaseSplitInformation( _stack.pop() );
+
+        DEBUG( _currentlyInStack.clear(); );
+        _fToViolations.clear();
+        _reluplex->setCurrentStackDepth( 0 );
+
+        for ( const auto &bound : levelZeroBounds )
+        {
+            if ( bound._isUpper )
+            {
+                if ( !upperBounds[bound._variable].finite() ||
+                     FloatUtils::lt( bound._bound, upperBounds[bound._variable].getBound() ) )
+                {
+                    _reluplex->updateUpperBound( bound._variable, bound._bound, 0 );
+                    ++_numLevelZeroBoundsKept;
+                }
+            }
+            else
+            {
+                if ( !lowerBounds[bound._variable].finite() ||
+                     FloatUtils::gt( bound._bound, lowerBounds[bound._variable].getBound() ) )
+                {
+                    _reluplex->updateLowerBound( bound._variable, bound._bound, 0 );
+                    ++_numLevelZeroBoundsKept;
+                }
+            }
+        }
+
+        ++_numRestarts;
+        _conflictsSinceRestart = 0;
+        _conflictsBeforeRestart = restartInterval( _numRestarts );
+
+        timeval end = Time::sampleMicro();
+        _totalSmtCoreTimeMilli += Time::timePassed( start, end );
+    }
+
+    // Called whenever a pair is dissolved, by a decision or otherwise
+    void notifyReluDissolved( unsigned f, IReluplex::ReluDissolutionType type )
+    {
+        if ( _useNogoods )
+            _pendingLiterals.append( NogoodDatabase::literal( f, type ) );
+    }
+
+    /*
+      Called before popping because of a conflict that followed from the given decisions: the
+      phases chosen at those stack levels cannot hold together.
+    */
+    void learnNogood( DecisionSet decisions )
+    {
+        if ( !_useNogoods )
+            return;
+
+        // Highest levels first, so that these are the watched ones
+        Vector<unsigned> literals;
+        for ( unsigned level = _stack.size(); level > 0; --level )
+        {
+            if ( !( decisions & decisionAtLevel( level ) ) )
+                continue;
+
+            const SplitInformation *decision = _stack.get( level - 1 );
+            IReluplex::ReluDissolutionType type =
+                ( decision->_type == SplitInformation::SPLITTING_RELU ) ? IReluplex::TYPE_SPLIT : IReluplex::TYPE_MERGE;
+            literals.append( NogoodDatabase::literal( decision->_variable, type ) );
+        }
+
+        if ( _nogoods.addNogood( literals ) )
+        {
+            ++_numNogoodsLearned;
+            SOLVER_LOG( *_log, LOG_SMT, LOG_DEBUG, "Learned a nogood of length %u\n", literals.size() );
+        }
+    }
+
+    /*
+      Dissolve the pairs that the learned nogoods force, in the phase opposite to the one they
+      rule out. Return false if a nogood is violated. The forced phases are not decisions, so
+      they depend on every decision on the stack.
+    */
+    bool propagateNogoods()
+    {
+        while ( !_pendingLiterals.empty() )
+        {
+            List<unsigned> literals = _pendingLiterals;
+            _pendingLiterals.clear();
+
+            for ( unsigned literal : literals )
+            {
+                if ( _nogoods.value( literal ) != NogoodDatabase::LITERAL_TRUE )
+                    continue;
+
+                List<unsigned> forced;
+                if ( !_nogoods.propagate( literal, forced ) )
+                {
+                    ++_numNogoodConflicts;
+                    _pendingLiterals.clear();
+                    return false;
+                }
+
+                for ( unsigned forcedLiteral : forced )
+                {
+                    NogoodDatabase::LiteralValue value = _nogoods.value( forcedLiteral );
+                    if ( value == NogoodDatabase::LITERAL_FALSE )
+                        continue;
+
+                    if ( value == NogoodDatabase::LITERAL_TRUE )
+                    {
+                        ++_numNogoodConflicts;
+                        _pendingLiterals.clear();
+                        return false;
+                    }
+
+                    unsigned f = NogoodDatabase::literalToF( forcedLiteral );
+                    SOLVER_LOG( *_log, LOG_SMT, LOG_DEBUG, "Nogood forces a %s on %s\n",
+                                NogoodDatabase::literalToType( forcedLiteral ) == IReluplex::TYPE_SPLIT ?
+                                "merge" : "split",
+                                _reluplex->toName( f ).ascii() );
+
+                    ++_numNogoodPropagations;
+                    if ( NogoodDatabase::literalToType( forcedLiteral ) == IReluplex::TYPE_SPLIT )
+                        _reluplex->updateLowerBound( f, 0.0, _stack.size() );
+                    else
+                        _reluplex->updateUpperBound( f, 0.0, _stack.size() );
+                }
+            }
+        }
+
+        return true;
+    }
+
 private:
-    Stack<SplitInformation *> _stack;
+    struct LevelZeroBound
+    {
+        LevelZeroBound( unsigned variable, double bound, bool isUpper )
+            : _variable( variable )
+            , _bound( bound )
+            , _isUpper( isUpper )
+        {
+        }
+
+        unsigned _variable;
+        double _bound;
+        bool _isUpper;
+    };
+
+    Vector<SplitInformation *> _stack;
+
+    // Popped states are kept for reuse, so that their tableaus keep their already-allocated entries
+    Stack<SplitInformation *> _recycledStates;
     IReluplex *_reluplex;
     unsigned _numVariables;
     Map<unsigned, unsigned> _fToViolations;
     unsigned long long _totalSmtCoreTimeMilli;
-    bool _logging;
+    SolverLog *_log;
+    BranchingHeuristic *_branchingHeuristic;
+    unsigned _numHeuristicChoices;
+
+    NogoodDatabase _nogoods;
+    bool _useNogoods;
+
+    // Literals that became true and were not propagated yet
+    List<unsigned> _pendingLiterals;
+
+    unsigned _numNogoodsLearned;
+    unsigned _numNogoodPropagations;
+    unsigned _numNogoodConflicts;
+
+    RestartPolicy _restartPolicy;
+    unsigned _numRestarts;
+    unsigned _conflictsSinceRestart;
+    unsigned _conflictsBeforeRestart;
+    unsigned _numLevelZeroBoundsKept;
+
+    // The phase each pair was last given by a decision, kept across restarts
+    Map<unsigned, SplitInformation::Type> _savedPhases;
 
     DEBUG(
           Set<unsigned> _currentlyInStack;
           );
 
-    void log( String message )
+    SplitInformation *allocateSplitInformation()
     {
-        if ( !_logging )
-            return;
+        if ( _recycledStates.empty() )
+            return new SplitInformation( _numVariables, _reluplex->getTableau()->getStorageType() );
+
+        SplitInformation *splitInformation = _recycledStates.top();
+        _recycledStates.pop();
+        return splitInformation;
+    }
+
+    void releaseSplitInformation( SplitInformation *splitInformation )
+    {
+        // Drop the references to shared compressed rows, or the live tableau would copy them
+        // on its next write
+        splitInformation->_tableau.deleteAllEntries();
+        _recycledStates.push( splitInformation );
+    }
+
+    // The number of conflicts allowed before the given restart (counting from 0)
+    unsigned restartInterval( unsigned restart ) const
+    {
+        if ( _restartPolicy == LUBY_RESTARTS )
+            return LUBY_RESTART_UNIT * luby( restart + 1 );
+
+        double interval = GEOMETRIC_RESTART_FIRST_INTERVAL;
+        for ( unsigned i = 0; i < restart && interval < MAX_RESTART_INTERVAL; ++i )
+            interval *= GEOMETRIC_RESTART_FACTOR;
+        return interval < MAX_RESTART_INTERVAL ? (unsigned)interval : MAX_RESTART_INTERVAL;
+    }
+
+    // The i'th element of the Luby sequence (1, 1, 2, 1, 1, 2, 4, ...), counting from 1
+    static unsigned luby( unsigned i )
+    {
+        unsigned k = 1;
+        while ( ( 1U << k ) - 1 < i )
+            ++k;
+
+        if ( i == ( 1U << k ) - 1 )
+            return 1U << ( k - 1 );
 
-        printf( "SMTCORE: %s", message.ascii() );
+        return luby( i - ( 1U << ( k - 1 ) ) + 1 );
     }
 };
 
@@ -0,0 +1,175 @@
+/*********************                                                        */
+/*! \file SolverLog.h
+ ** \verbatim
+ ** Top contributors (to current version):
+ **   Guy Katz
+ ** This file is part of the Reluplex project.
+ ** Copyright (c) 2016-2017 by the authors listed in the file AUTHORS
+ ** (in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved. See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **/
+
+#ifndef __SolverLog_h__
+#define __SolverLog_h__
+
+#include <cstdarg>
+#include <cstdio>
+#include <string.h>
+
+enum LogLevel {
+    LOG_NONE = 0,
+    // Events that happen a few times per call to progress()
+    LOG_DEBUG = 1,
+    // Individual pivots, updates and state dumps
+    LOG_TRACE = 2,
+};
+
+enum LogCategory {
+    LOG_SEARCH = 0,
+    LOG_SIMPLEX = 1,
+    LOG_RELU = 2,
+    LOG_BOUNDS = 3,
+    LOG_GLPK = 4,
+    LOG_SMT = 5,
+    NUM_LOG_CATEGORIES = 6,
+};
+
+// Messages above this level are compiled out. Build with "make MAX_LOG_LEVEL=<n>" to change it.
+#ifndef SOLVER_LOG_MAX_LEVEL
+#define SOLVER_LOG_MAX_LEVEL LOG_TRACE
+#endif
+
+/*
+  Log a printf-style message. The arguments are only evaluated if the category is enabled
+  at the given level, so a disabled message costs a single branch.
+*/
+#define SOLVER_LOG( log, category, level, ... )                         \
+    do                                                                  \
+    {                                                                   \
+        if ( ( level ) <= SOLVER_LOG_MAX_LEVEL &&                       \
+             ( log ).enabled( ( category ), ( level ) ) )               \
+            ( log ).write( ( category ), __VA_ARGS__ );                 \
+    } while ( 0 )
+
+/*
+  The log of a single solver. Each category has its own level, and messages are
+  collected in a buffer that is written out when it fills up, or on flush().
+*/
+class SolverLog
+{
+public:
+    enum {
+        BUFFER_SIZE = 1 << 16,
+        MAX_MESSAGE_LENGTH = 10000,
+    };
+
+    SolverLog()
+        : _output( stdout )
+        , _buffer( NULL )
+        , _used( 0 )
+    {
+        for ( unsigned i = 0; i < NUM_LOG_CATEGORIES; ++i )
+            _levels[i] = LOG_NONE;
+    }
+
+    ~SolverLog()
+    {
+        flush();
+
+        if ( _buffer )
+        {
+            delete[] _buffer;
+            _buffer = NULL;
+        }
+    }
+
+    bool enabled( LogCategory category, LogLevel level ) const
+    {
+        return level <= _levels[category];
+    }
+
+    void setLevel( LogCategory category, LogLevel level )
+    {
+        _levels[category] = level;
+    }
+
+    void setLevel( LogLevel level )
+    {
+        for ( unsigned i = 0; i < NUM_LOG_CATEGORIES; ++i )
+            _levels[i] = level;
+    }
+
+    void setOutput( FILE *output )
+    {
+        flush();
+        _output = output;
+    }
+
+    void write( LogCategory category, const char *format, ... )
+        __attribute__(( format( printf, 3, 4 ) ))
+    {
+        if ( !_buffer )
+            _buffer = new char[BUFFER_SIZE];
+
+        const char *prefix = categoryPrefix( category );
+        unsigned prefixLength = strlen( prefix );
+
+        if ( _used + prefixLength + MAX_MESSAGE_LENGTH > BUFFER_SIZE )
+            flush();
+
+        memcpy( _buffer + _used, prefix, prefixLength );
+        _used += prefixLength;
+
+        va_list argList;
+        va_start( argList, format );
+        int length = vsnprintf( _buffer + _used, MAX_MESSAGE_LENGTH, format, argList );
+        va_end( argList );
+
+        if ( length < 0 )
+            return;
+
+        if ( length >= MAX_MESSAGE_LENGTH )
+            length = MAX_MESSAGE_LENGTH - 1;
+        _used += length;
+    }
+
+    void flush()
+    {
+        if ( _used == 0 )
+            return;
+
+        fwrite( _buffer, 1, _used, _output );
+        fflush( _output );
+        _used = 0;
+    }
+
+    static const char *categoryPrefix( LogCategory category )
+    {
+        switch ( category )
+        {
+        case LOG_GLPK:
+            return "GlpkWrapper: ";
+        case LOG_SMT:
+            return "SMTCORE: ";
+        default:
+            return "";
+        }
+    }
+
+private:
+    LogLevel _levels[NUM_LOG_CATEGORIES];
+    FILE *_output;
+    char *_buffer;
+    unsigned _used;
+};
+
+#endif // __SolverLog_h__
+
+//
+// Local Variables:
+// compile-command: "make -C . "
+// tags-file-name: "./TAGS"
+// c-basic-offset: 4
+// End:
+//
@@ -0,0 +1,360 @@
+/*********************                                                        */
+/*! \file SymbolicBoundTightener.h
+ ** \verbatim
+ ** Top contributors (to current version):
+ **   Guy Katz
+ ** This file is part of the Reluplex project.
+ ** Copyright (c) 2016-2017 by the authors listed in the file AUTHORS
+ ** (in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved. See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **/
+
+#ifndef __SymbolicBoundTightener_h__
+#define __SymbolicBoundTightener_h__
+
+#include "VariableBound.h"
+#include "Vector.h"
+
+#include <string.h>
+
+/*
+  Bounds for the neurons of a feed-forward ReLU network, computed symbolically: every neuron
+  gets a linear lower bound and a linear upper bound in terms of the network's inputs, which
+  are then minimized and maximized over the input box. A ReLU whose phase is not known is
+  over-approximated by a triangle: its upper bound is the line through (l, 0) and (u, u),
+  and its lower bound is either 0 or its input, whichever is closer.
+
+  Layer 0 is the input layer. Every other layer has a weighted-sum (b) variable for each of
+  its neurons, and every layer except the last also has a ReLU (f) variable. The current
+  bounds of all these variables are taken into account, so the result becomes tighter as
+  the search fixes ReLU phases.
+*/
+class SymbolicBoundTightener
+{
+public:
+    SymbolicBoundTightener( const Vector<unsigned> &layerSizes )
+        : _numLayers( layerSizes.size() )
+        , _numInputs( layerSizes.get( 0 ) )
+        , _level( 0 )
+    {
+        _layerSizes = new unsigned[_numLayers];
+        _weights = new double *[_numLayers];
+        _biases = new double *[_numLayers];
+        _bVariables = new unsigned *[_numLayers];
+        _fVariables = new unsigned *[_numLayers];
+        _lowerBounds = new double *[_numLayers];
+        _upperBounds = new double *[_numLayers];
+
+        unsigned maxSize = 0;
+        for ( unsigned layer = 0; layer < _numLayers; ++layer )
+        {
+            unsigned size = layerSizes.get( layer );
+            unsigned previousSize = ( layer == 0 ) ? 0 : _layerSizes[layer - 1];
+
+            _layerSizes[layer] = size;
+            _weights[layer] = new double[size * previousSize];
+            _biases[layer] = new double[size];
+            _bVariables[layer] = new unsigned[size];
+            _fVariables[layer] = new unsigned[size];
+            _lowerBounds[layer] = new double[size];
+            _upperBounds[layer] = new double[size];
+
+            memset( _weights[layer], 0, sizeof(double) * size * previousSize );
+            memset( _biases[layer], 0, sizeof(double) * size );
+            memset( _bVariables[layer], 0, sizeof(unsigned) * size );
+            memset( _fVariables[layer], 0, sizeof(unsigned) * size );
+
+            if ( size > maxSize )
+                maxSize = size;
+        }
+
+        // Symbolic bounds are kept for one layer at a time: a coefficient per input, and a constant
+        unsigned formSize = maxSize * ( _numInputs + 1 );
+        _previousLower = new double[formSize];
+        _previousUpper = new double[formSize];
+        _currentLower = new double[formSize];
+        _currentUpper = new double[formSize];
+    }
+
+    ~SymbolicBoundTightener()
+    {
+        for ( unsigned layer = 0; layer < _numLayers; ++layer )
+        {
+            delete[] _weights[layer];
+            delete[] _biases[layer];
+            delete[] _bVariables[layer];
+            delete[] _fVariables[layer];
+            delete[] _lowerBounds[layer];
+            delete[] _upperBounds[layer];
+        }
+
+        delete[] _weights;
+        delete[] _biases;
+        delete[] _bVariables;
+        delete[] _fVariables;
+        delete[] _lowerBounds;
+        delete[] _upperBounds;
+        delete[] _layerSizes;
+
+        delete[] _previousLower;
+        delete[] _previousUpper;
+        delete[] _currentLower;
+        delete[] _currentUpper;
+    }
+
+    unsigned getNumLayers() const
+    {
+        return _numLayers;
+    }
+
+    unsigned getLayerSize( unsigned layer ) const
+    {
+        return _layerSizes[layer];
+    }
+
+    void setWeight( unsigned sourceLayer, unsigned sourceNeuron, unsigned targetNeuron, double weight )
+    {
+        _weights[sourceLayer + 1][targetNeuron * _layerSizes[sourceLayer] + sourceNeuron] = weight;
+    }
+
+    void setBias( unsigned layer, unsigned neuron, double bias )
+    {
+        _biases[layer][neuron] = bias;
+    }
+
+    double getWeight( unsigned sourceLayer, unsigned sourceNeuron, unsigned targetNeuron ) const
+    {
+        return _weights[sourceLayer + 1][targetNeuron * _layerSizes[sourceLayer] + sourceNeuron];
+    }
+
+    double getBias( unsigned layer, unsigned neuron ) const
+    {
+        return _biases[layer][neuron];
+    }
+
+    void setInputVariable( unsigned neuron, unsigned variable )
+    {
+        _bVariables[0][neuron] = variable;
+        _fVariables[0][neuron] = variable;
+    }
+
+    // For the output layer, f should be the same as b
+    void setNeuronVariables( unsigned layer, unsigned neuron, unsigned b, unsigned f )
+    {
+        _bVariables[layer][neuron] = b;
+        _fVariables[layer][neuron] = f;
+    }
+
+    unsigned getBVariable( unsigned layer, unsigned neuron ) const
+    {
+        return _bVariables[layer][neuron];
+    }
+
+    unsigned getFVariable( unsigned layer, unsigned neuron ) const
+    {
+        return _fVariables[layer][neuron];
+    }
+
+    bool hasRelu( unsigned layer ) const
+    {
+        return layer > 0 && layer + 1 < _numLayers;
+    }
+
+    // The bounds computed for the b variable of a neuron by the last call to run()
+    double getLowerBound( unsigned layer, unsigned neuron ) const
+    {
+        return _lowerBounds[layer][neuron];
+    }
+
+    double getUpperBound( unsigned layer, unsigned neuron ) const
+    {
+        return _upperBounds[layer][neuron];
+    }
+
+    // The highest level of the bounds used by the last call to run()
+    unsigned getLevel() const
+    {
+        return _level;
+    }
+
+    void run( const VariableBound *lowerBounds, const VariableBound *upperBounds )
+    {
+        _level = 0;
+        unsigned width = _numInputs + 1;
+
+        // The inputs are bounded by themselves
+        for ( unsigned i = 0; i < _numInputs; ++i )
+        {
+            unsigned variable = _bVariables[0][i];
+            _lowerBounds[0][i] = lowerBounds[variable].getBound();
+            _upperBounds[0][i] = upperBounds[variable].getBound();
+            useLevel( lowerBounds[variable] );
+            useLevel( upperBounds[variable] );
+
+            for ( unsigned j = 0; j < width; ++j )
+            {
+                _previousLower[i * width + j] = ( i == j ) ? 1.0 : 0.0;
+                _previousUpper[i * width + j] = ( i == j ) ? 1.0 : 0.0;
+            }
+        }
+
+        for ( unsigned layer = 1; layer < _numLayers; ++layer )
+        {
+            unsigned size = _layerSizes[layer];
+            unsigned previousSize = _layerSizes[layer - 1];
+
+            for ( unsigned neuron = 0; neuron < size; ++neuron )
+            {
+                double *lower = _currentLower + neuron * width;
+                double *upper = _currentUpper + neuron * width;
+
+                for ( unsigned j = 0; j < _numInputs; ++j )
+                {
+                    lower[j] = 0.0;
+                    upper[j] = 0.0;
+                }
+                lower[_numInputs] = _biases[layer][neuron];
+                upper[_numInputs] = _biases[layer][neuron];
+
+                const double *weights = _weights[layer] + neuron * previousSize;
+                for ( unsigned source = 0; source < previousSize; ++source )
+                {
+                    double weight = weights[source];
+                    if ( weight == 0.0 )
+                        continue;
+
+                    // A positive weight takes the source's lower bound into the lower bound
+                    const double *sourceForLower = ( weight > 0 ) ? _previousLower : _previousUpper;
+                    const double *sourceForUpper = ( weight > 0 ) ? _previousUpper : _previousLower;
+                    sourceForLower += source * width;
+                    sourceForUpper += source * width;
+
+                    for ( unsigned j = 0; j < width; ++j )
+                    {
+                        lower[j] += weight * sourceForLower[j];
+                        upper[j] += weight * sourceForUpper[j];
+                    }
+                }
+
+                double lb = minimize( lower );
+                double ub = maximize( upper );
+
+                unsigned b = _bVariables[layer][neuron];
+                if ( lowerBounds[b].finite() && lowerBounds[b].getBound() > lb )
+                {
+                    lb = lowerBounds[b].getBound();
+                    useLevel( lowerBounds[b] );
+                }
+                if ( upperBounds[b].finite() && upperBounds[b].getBound() < ub )
+                {
+                    ub = upperBounds[b].getBound();
+                    useLevel( upperBounds[b] );
+                }
+
+                _lowerBounds[layer][neuron] = lb;
+                _upperBounds[layer][neuron] = ub;
+
+                if ( hasRelu( layer ) )
+                    relax( lower, upper, lb, ub );
+            }
+
+            // The next layer is computed from this one
+            memcpy( _previousLower, _currentLower, sizeof(double) * size * width );
+            memcpy( _previousUpper, _currentUpper, sizeof(double) * size * width );
+        }
+    }
+
+private:
+    unsigned _numLayers;
+    unsigned _numInputs;
+    unsigned *_layerSizes;
+
+    // For each layer, the weights into it (by target neuron, then source neuron) and its biases
+    double **_weights;
+    double **_biases;
+
+    unsigned **_bVariables;
+    unsigned **_fVariables;
+
+    double **_lowerBounds;
+    double **_upperBounds;
+
+    double *_previousLower;
+    double *_previousUpper;
+    double *_currentLower;
+    double *_currentUpper;
+
+    unsigned _level;
+
+    SymbolicBoundTightener( const SymbolicBoundTightener & );
+    SymbolicBoundTightener &operator=( const SymbolicBoundTightener & );
+
+    void useLevel( const VariableBound &bound )
+    {
+        if ( bound.getLevel() > _level )
+            _level = bound.getLevel();
+    }
+
+    double minimize( const double *form ) const
+    {
+        double result = form[_numInputs];
+        for ( unsigned i = 0; i < _numInputs; ++i )
+            result += form[i] * ( ( form[i] > 0 ) ? _lowerBounds[0][i] : _upperBounds[0][i] );
+        return result;
+    }
+
+    double maximize( const double *form ) const
+    {
+        double result = form[_numInputs];
+        for ( unsigned i = 0; i < _numInputs; ++i )
+            result += form[i] * ( ( form[i] > 0 ) ? _upperBounds[0][i] : _lowerBounds[0][i] );
+        return result;
+    }
+
+    // Turn the symbolic bounds of a b variable, whose concrete bounds are [lb, ub], into those of its f
+    void relax( double *lower, double *upper, double lb, double ub ) const
+    {
+        unsigned width = _numInputs + 1;
+
+        if ( lb >= 0 )
+        {
+            // Active: f = b
+            return;
+        }
+
+        if ( ub <= 0 )
+        {
+            // Inactive: f = 0
+            for ( unsigned j = 0; j < width; ++j )
+            {
+                lower[j] = 0.0;
+                upper[j] = 0.0;
+            }
+            return;
+        }
+
+        // Unstable: f <= ub * ( b - lb ) / ( ub - lb )
+        double slope = ub / ( ub - lb );
+        for ( unsigned j = 0; j < width; ++j )
+            upper[j] *= slope;
+        upper[_numInputs] -= slope * lb;
+
+        // f >= b or f >= 0, whichever loses less area
+        if ( ub < -lb )
+        {
+            for ( unsigned j = 0; j < width; ++j )
+                lower[j] = 0.0;
+        }
+    }
+};
+
+#endif // __SymbolicBoundTightener_h__
+
+//
+// Local Variables:
+// compile-command: "make -C . "
+// tags-file-name: "./TAGS"
+// c-basic-offset: 4
+// End:
+//
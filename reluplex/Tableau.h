@@ -16,8 +16,26 @@
 #include "Map.h"
 #include "Debug.h"
 #include "FloatUtils.h"
+#include "ThreadPool.h"
 #include "Vector.h"
 
+#include <string.h>
+
+#if defined( __GNUC__ ) && ( defined( __x86_64__ ) || defined( __i386__ ) )
+#define TABLEAU_AVX2_KERNEL
+#include <immintrin.h>
+#endif
+
+// Tableau entries are carved out of slabs of this many entries at a time
+static const unsigned TABLEAU_ENTRIES_PER_SLAB = 1024;
+
+// Initial capacity of a row in the compressed storage. Rows double in size when they fill up.
+static const unsigned TABLEAU_INITIAL_ROW_CAPACITY = 8;
+
+// In the compressed storage, a row that covers at least this fraction of the columns is
+// stored as a dense array, and goes back to being sparse once it covers less than half of it.
+static const double TABLEAU_DENSE_ROW_FRACTION = 0.2;
+
 class Tableau
 {
 public:
@@ -134,22 +152,259 @@ public:
         double _value;
     };
 
-    Tableau( unsigned size )
+    /*
+      The storage engine is chosen when the tableau is constructed.
+    */
+    enum StorageType {
+        // Orthogonal doubly-linked lists: every entry is linked into both its row and its column
+        LINKED_LISTS = 0,
+        // Contiguous per-row arrays with slack capacity, and a column index that is
+        // rebuilt lazily, only when a column is requested after the structure has changed
+        COMPRESSED_ROWS = 1,
+    };
+
+    struct RowEntry
+    {
+        unsigned _column;
+        double _value;
+    };
+
+    // An entry in the column index: the row, and the position of the entry within that row
+    struct ColumnEntry
+    {
+        unsigned _row;
+        unsigned _slot;
+    };
+
+    /*
+      A row is either sparse (an array of entries) or dense (an array of values indexed by
+      column, in which missing entries are exactly 0). Either array may be shared between a
+      tableau and its snapshots, in which case it is copied before it is first modified
+      (copy-on-write).
+    */
+    struct CompressedRow
+    {
+        RowEntry *_entries;
+        double *_dense;
+        unsigned *_references;
+        unsigned _size;
+        unsigned _capacity;
+    };
+
+    /*
+      Traverses a single row or column, regardless of the storage engine. Iterators are
+      invalidated by changes to the structure of the tableau, except for changes to
+      the rows that have already been traversed.
+    */
+    class Iterator
+    {
+    public:
+        enum Type {
+            LINKED_ROW,
+            LINKED_COLUMN,
+            COMPRESSED_ROW,
+            COMPRESSED_COLUMN,
+            DENSE_ROW,
+        };
+
+        Iterator()
+            : _type( LINKED_ROW )
+            , _entry( NULL )
+            , _rowEntries( NULL )
+            , _denseValues( NULL )
+            , _columnEntries( NULL )
+            , _rows( NULL )
+            , _index( 0 )
+            , _position( 0 )
+            , _size( 0 )
+        {
+        }
+
+        static Iterator linked( const Entry *entry, bool alongRow )
+        {
+            Iterator iterator;
+            iterator._type = alongRow ? LINKED_ROW : LINKED_COLUMN;
+            iterator._entry = entry;
+            return iterator;
+        }
+
+        static Iterator compressedRow( unsigned row, const CompressedRow &compressedRow, unsigned numColumns )
+        {
+            Iterator iterator;
+
+            if ( compressedRow._dense )
+            {
+                iterator._type = DENSE_ROW;
+                iterator._denseValues = compressedRow._dense;
+                iterator._index = row;
+                iterator._size = numColumns;
+                iterator.skipDenseZeros();
+                return iterator;
+            }
+
+            iterator._type = COMPRESSED_ROW;
+            iterator._rowEntries = compressedRow._entries;
+            iterator._index = row;
+            iterator._size = compressedRow._size;
+            return iterator;
+        }
+
+        static Iterator compressedColumn( unsigned column, const ColumnEntry *columnEntries,
+                                          unsigned size, const CompressedRow *rows )
+        {
+            Iterator iterator;
+            iterator._type = COMPRESSED_COLUMN;
+            iterator._columnEntries = columnEntries;
+            iterator._rows = rows;
+            iterator._index = column;
+            iterator._size = size;
+            return iterator;
+        }
+
+        bool atEnd() const
+        {
+            if ( _type == LINKED_ROW || _type == LINKED_COLUMN )
+                return _entry == NULL;
+            return _position == _size;
+        }
+
+        void advance()
+        {
+            if ( _type == LINKED_ROW )
+                _entry = _entry->nextInRow();
+            else if ( _type == LINKED_COLUMN )
+                _entry = _entry->nextInColumn();
+            else
+            {
+                ++_position;
+                if ( _type == DENSE_ROW )
+                    skipDenseZeros();
+            }
+        }
+
+        unsigned getRow() const
+        {
+            if ( _type == LINKED_ROW || _type == LINKED_COLUMN )
+                return _entry->getRow();
+            if ( _type == COMPRESSED_ROW || _type == DENSE_ROW )
+                return _index;
+            return _columnEntries[_position]._row;
+        }
+
+        unsigned getColumn() const
+        {
+            if ( _type == LINKED_ROW || _type == LINKED_COLUMN )
+                return _entry->getColumn();
+            if ( _type == COMPRESSED_ROW )
+                return _rowEntries[_position]._column;
+            if ( _type == DENSE_ROW )
+                return _position;
+            return _index;
+        }
+
+        double getValue() const
+        {
+            if ( _type == LINKED_ROW || _type == LINKED_COLUMN )
+                return _entry->getValue();
+            if ( _type == COMPRESSED_ROW )
+                return _rowEntries[_position]._value;
+            if ( _type == DENSE_ROW )
+                return _denseValues[_position];
+
+            // In dense rows, the position of an entry is its column
+            const ColumnEntry &columnEntry( _columnEntries[_position] );
+            const CompressedRow &row( _rows[columnEntry._row] );
+            return row._dense ? row._dense[columnEntry._slot] : row._entries[columnEntry._slot]._value;
+        }
+
+    private:
+        Type _type;
+        const Entry *_entry;
+        const RowEntry *_rowEntries;
+        const double *_denseValues;
+        const ColumnEntry *_columnEntries;
+        const CompressedRow *_rows;
+        unsigned _index;
+        unsigned _position;
+        unsigned _size;
+
+        void skipDenseZeros()
+        {
+            while ( _position < _size && _denseValues[_position] == 0.0 )
+                ++_position;
+        }
+    };
+
+    Tableau( unsigned size, StorageType storageType = LINKED_LISTS )
         : _size( size )
+        , _storageType( storageType )
         , _rows( NULL )
         , _columns( NULL )
+        , _denseMap( NULL )
+        , _touchedIndices( NULL )
+        , _numTouchedIndices( 0 )
+        , _freeEntries( NULL )
+        , _currentSlab( 0 )
+        , _nextInSlab( 0 )
+        , _compressedRows( NULL )
+        , _scatteredSlots( NULL )
+        , _threadWorkspaces( NULL )
+        , _numThreadWorkspaces( 0 )
+        , _columnStart( NULL )
+        , _columnEntries( NULL )
+        , _columnEntriesCapacity( 0 )
+        , _columnIndexValid( false )
+        , _numRowCopies( 0 )
+        , _denseRowThreshold( 0 )
     {
         _rows = new Tableau::Entry *[size];
         _columns = new Tableau::Entry *[size];
+        _denseMap = new Tableau::Entry *[size];
+        _touchedIndices = new unsigned[size];
 
         for ( unsigned i = 0; i < _size; ++i )
         {
             _rows[i] = NULL;
             _columns[i] = NULL;
+            _denseMap[i] = NULL;
 
             _rowSize.append( 0 );
             _columnSize.append( 0 );
         }
+
+        if ( _storageType == COMPRESSED_ROWS )
+        {
+            _compressedRows = new CompressedRow[size];
+            _scatteredSlots = new unsigned[size];
+            _columnStart = new unsigned[size + 1];
+
+            _workspace._scatteredSlots = _scatteredSlots;
+            _workspace._touchedIndices = _touchedIndices;
+
+            _denseRowThreshold = (unsigned)( _size * TABLEAU_DENSE_ROW_FRACTION );
+            if ( _denseRowThreshold < 2 )
+                _denseRowThreshold = 2;
+
+            for ( unsigned i = 0; i < _size; ++i )
+            {
+                _compressedRows[i]._entries = NULL;
+                _compressedRows[i]._dense = NULL;
+                _compressedRows[i]._references = NULL;
+                _compressedRows[i]._size = 0;
+                _compressedRows[i]._capacity = 0;
+                _scatteredSlots[i] = 0;
+            }
+        }
+    }
+
+    StorageType getStorageType() const
+    {
+        return _storageType;
+    }
+
+    static const char *storageTypeToString( StorageType storageType )
+    {
+        return storageType == COMPRESSED_ROWS ? "compressed rows" : "linked lists";
     }
 
     unsigned getNumVars() const
@@ -159,9 +414,29 @@ public:
 
     ~Tableau()
     {
-        deleteAllEntries();
+        for ( unsigned i = 0; i < _slabs.size(); ++i )
+            delete []_slabs[i];
+        _slabs.clear();
+
         delete []_rows;
         delete []_columns;
+        delete []_denseMap;
+        delete []_touchedIndices;
+
+        if ( _compressedRows )
+        {
+            for ( unsigned i = 0; i < _size; ++i )
+                releaseRowEntries( _compressedRows[i] );
+            delete []_compressedRows;
+        }
+
+        delete []_scatteredSlots;
+        delete []_columnStart;
+        delete []_columnEntries;
+
+        for ( unsigned i = 0; i < _numThreadWorkspaces; ++i )
+            _threadWorkspaces[i].freeArrays();
+        delete []_threadWorkspaces;
     }
 
     unsigned totalSize() const
@@ -173,21 +448,49 @@ public:
         return total;
     }
 
-    void deleteAllEntries()
+    double maxAbsoluteEntry() const
     {
+        double result = 0.0;
+
         for ( unsigned i = 0; i < _size; ++i )
         {
-            Entry *current, *next;
-            current = _rows[i];
+            Iterator entry = getRow( i );
+            while ( !entry.atEnd() )
+            {
+                double value = FloatUtils::abs( entry.getValue() );
+                if ( value > result )
+                    result = value;
+                entry.advance();
+            }
+        }
+
+        return result;
+    }
 
-            while ( current )
+    void deleteAllEntries()
+    {
+        if ( _storageType == COMPRESSED_ROWS )
+        {
+            // Row arrays that are not shared keep their capacity
+            for ( unsigned i = 0; i < _size; ++i )
             {
-                next = current->nextInRow();
-                delete current;
-                current = next;
+                if ( rowIsShared( _compressedRows[i] ) || _compressedRows[i]._dense )
+                    releaseRowEntries( _compressedRows[i] );
+                _compressedRows[i]._size = 0;
+                _columnSize[i] = 0;
+                _rowSize[i] = 0;
             }
+
+            _columnIndexValid = false;
+            return;
         }
 
+        // All entries live in the slabs, so there is no need to release them one by one.
+        // The slabs are kept, and will be reused by subsequent allocations.
+        _freeEntries = NULL;
+        _currentSlab = 0;
+        _nextInSlab = 0;
+
         for ( unsigned i = 0; i < _size; ++i )
         {
             _rows[i] = NULL;
@@ -200,6 +503,21 @@ public:
     // By row
     double getCell( unsigned row, unsigned column ) const
     {
+        if ( _storageType == COMPRESSED_ROWS )
+        {
+            const CompressedRow &compressedRow( _compressedRows[row] );
+            if ( compressedRow._dense )
+                return compressedRow._dense[column];
+
+            for ( unsigned i = 0; i < compressedRow._size; ++i )
+            {
+                if ( compressedRow._entries[i]._column == column )
+                    return compressedRow._entries[i]._value;
+            }
+
+            return 0.0;
+        }
+
         Entry *rowEntry = _rows[row];
 
         while ( rowEntry != NULL )
@@ -219,7 +537,16 @@ public:
         if ( FloatUtils::isZero( value ) )
             return;
 
-        Entry *entry = new Entry;
+        if ( _storageType == COMPRESSED_ROWS )
+        {
+            appendToRow( row, column, value );
+            ++_rowSize[row];
+            ++_columnSize[column];
+            _columnIndexValid = false;
+            return;
+        }
+
+        Entry *entry = allocateEntry();
         entry->setRow( row );
         entry->setColumn( column );
         entry->setValue( value );
@@ -241,14 +568,15 @@ public:
 
     bool activeRow( unsigned row ) const
     {
-        return _rows[row] != NULL;
+        return _rowSize.get( row ) != 0;
     }
 
     bool activeColumn( unsigned column ) const
     {
-        return _columns[column] != NULL;
+        return _columnSize.get( column ) != 0;
     }
 
+    // Only applicable to the linked lists storage
     void eraseEntry( Entry *entry )
     {
         if ( entry->nextInRow() )
@@ -269,11 +597,29 @@ public:
         --_rowSize[entry->getRow()];
         --_columnSize[entry->getColumn()];
 
-        delete entry;
+        releaseEntry( entry );
     }
 
     void eraseRow( unsigned row )
     {
+        if ( _storageType == COMPRESSED_ROWS )
+        {
+            Iterator entry = getRow( row );
+            while ( !entry.atEnd() )
+            {
+                --_columnSize[entry.getColumn()];
+                entry.advance();
+            }
+
+            CompressedRow &compressedRow( _compressedRows[row] );
+            if ( rowIsShared( compressedRow ) || compressedRow._dense )
+                releaseRowEntries( compressedRow );
+            compressedRow._size = 0;
+            _rowSize[row] = 0;
+            _columnIndexValid = false;
+            return;
+        }
+
         Entry *entry = _rows[row];
         Entry *next;
 
@@ -289,7 +635,7 @@ public:
             --_columnSize[entry->getColumn()];
 
             next = entry->nextInRow();
-            delete entry;
+            releaseEntry( entry );
             entry = next;
         }
 
@@ -299,6 +645,12 @@ public:
 
     void eraseColumn( unsigned column )
     {
+        if ( _storageType == COMPRESSED_ROWS )
+        {
+            compressedEraseColumn( column );
+            return;
+        }
+
         Entry *entry = _columns[column];
         Entry *next;
 
@@ -314,7 +666,7 @@ public:
             --_rowSize[entry->getRow()];
 
             next = entry->nextInColumn();
-            delete entry;
+            releaseEntry( entry );
             entry = next;
         }
 
@@ -330,12 +682,17 @@ public:
         if ( !activeRow( source ) )
             return;
 
-        _denseMap.clear();
+        if ( _storageType == COMPRESSED_ROWS )
+        {
+            compressedAddScaledRow( _workspace, source, scale, target, guaranteeIndex, guaranteeValue );
+            collectWorkspace( _workspace, numCalcs );
+            return;
+        }
 
         Entry *targetEntry = _rows[target];
         while ( targetEntry != NULL )
         {
-            _denseMap[targetEntry->getColumn()] = targetEntry;
+            scatter( targetEntry->getColumn(), targetEntry );
             targetEntry = targetEntry->nextInRow();
         }
 
@@ -348,9 +705,7 @@ public:
             sourceEntry = sourceEntry->nextInRow();
 
             column = current->getColumn();
-            Entry *entryInTarget = NULL;
-            if ( _denseMap.exists( column ) )
-                entryInTarget = _denseMap[column];
+            Entry *entryInTarget = _denseMap[column];
 
             double newValue = current->getValue() * scale;
 
@@ -371,7 +726,7 @@ public:
 
                 if ( FloatUtils::isZero( entryInTarget->getValue() ) )
                 {
-                    _denseMap.erase( column );
+                    _denseMap[column] = NULL;
                     eraseEntry( entryInTarget );
                 }
             }
@@ -384,6 +739,81 @@ public:
                     addEntry( target, column, guaranteeValue );
             }
         }
+
+        clearDenseMap();
+    }
+
+    /*
+      Eliminate a column from every row other than the source row: each such row receives
+      the source row, scaled by the row's entry in the column, and that entry becomes zero.
+      With the compressed storage, a pool of several threads and a column of at least
+      parallelThreshold entries, the rows are divided between the threads.
+    */
+    void eliminateColumn( unsigned source, unsigned column,
+                          ThreadPool *threadPool, unsigned parallelThreshold,
+                          unsigned *numCalcs = NULL )
+    {
+        if ( ( _storageType != COMPRESSED_ROWS ) ||
+             ( threadPool == NULL ) ||
+             ( threadPool->getNumThreads() == 1 ) ||
+             ( getColumnSize( column ) < parallelThreshold ) )
+        {
+            Iterator columnEntry = getColumn( column );
+            Iterator current;
+
+            while ( !columnEntry.atEnd() )
+            {
+                current = columnEntry;
+                columnEntry.advance();
+
+                if ( current.getRow() != source )
+                    addScaledRow( source, current.getValue(), current.getRow(), column, 0.0, numCalcs );
+            }
+
+            return;
+        }
+
+        if ( !activeRow( source ) )
+            return;
+
+        // Collect the targets first, as the column index is not maintained while rows change
+        _eliminationTargets.clear();
+        Iterator columnEntry = getColumn( column );
+        while ( !columnEntry.atEnd() )
+        {
+            if ( columnEntry.getRow() != source )
+            {
+                EliminationTarget target;
+                target._row = columnEntry.getRow();
+                target._scale = columnEntry.getValue();
+                _eliminationTargets.append( target );
+            }
+
+            columnEntry.advance();
+        }
+
+        unsigned numThreads = threadPool->getNumThreads();
+        allocateThreadWorkspaces( numThreads );
+
+        unsigned numTargets = _eliminationTargets.size();
+        threadPool->run( [&]( unsigned thread )
+                         {
+                             RowWorkspace &workspace( _threadWorkspaces[thread] );
+                             unsigned begin = ( numTargets * thread ) / numThreads;
+                             unsigned end = ( numTargets * ( thread + 1 ) ) / numThreads;
+
+                             for ( unsigned i = begin; i < end; ++i )
+                             {
+                                 compressedAddScaledRow( workspace,
+                                                         source,
+                                                         _eliminationTargets[i]._scale,
+                                                         _eliminationTargets[i]._row,
+                                                         column, 0.0 );
+                             }
+                         } );
+
+        for ( unsigned i = 0; i < numThreads; ++i )
+            collectWorkspace( _threadWorkspaces[i], numCalcs );
     }
 
     void addColumnEraseSource( unsigned source, unsigned target )
@@ -391,12 +821,16 @@ public:
         if ( !activeColumn( source ) )
             return;
 
-        _denseMap.clear();
+        if ( _storageType == COMPRESSED_ROWS )
+        {
+            compressedAddColumnEraseSource( source, target );
+            return;
+        }
 
         Entry *targetEntry = _columns[target];
         while ( targetEntry != NULL )
         {
-            _denseMap[targetEntry->getRow()] = targetEntry;
+            scatter( targetEntry->getRow(), targetEntry );
             targetEntry = targetEntry->nextInColumn();
         }
 
@@ -410,16 +844,15 @@ public:
             sourceEntry = sourceEntry->nextInColumn();
 
             row = current->getRow();
-            Entry *entryInTarget = NULL;
-            if ( _denseMap.exists( row ) )
+            Entry *entryInTarget = _denseMap[row];
+            if ( entryInTarget )
             {
                 // Add from source column to target column
-                entryInTarget = _denseMap[row];
                 entryInTarget->setValue( entryInTarget->getValue() + current->getValue() );
 
                 if ( FloatUtils::isZero( entryInTarget->getValue() ) )
                 {
-                    _denseMap.erase( row );
+                    _denseMap[row] = NULL;
                     eraseEntry( entryInTarget );
                 }
             }
@@ -451,7 +884,7 @@ public:
         }
 
         eraseColumn( source );
-        _denseMap.clear();
+        clearDenseMap();
     }
 
     unsigned getRowSize( unsigned row ) const
@@ -464,14 +897,28 @@ public:
         return _columnSize.get( column );
     }
 
-    const Entry *getRow( unsigned row ) const
+    Iterator getRow( unsigned row ) const
     {
-        return _rows[row];
+        if ( _storageType == COMPRESSED_ROWS )
+            return Iterator::compressedRow( row, _compressedRows[row], _size );
+
+        return Iterator::linked( _rows[row], true );
     }
 
-    const Entry *getColumn( unsigned column ) const
+    Iterator getColumn( unsigned column ) const
     {
-        return _columns[column];
+        if ( _storageType == COMPRESSED_ROWS )
+        {
+            if ( !_columnIndexValid )
+                rebuildColumnIndex();
+
+            return Iterator::compressedColumn( column,
+                                               _columnEntries + _columnStart[column],
+                                               _columnSize.get( column ),
+                                               _compressedRows );
+        }
+
+        return Iterator::linked( _columns[column], false );
     }
 
     void printRow( unsigned row )
@@ -479,19 +926,19 @@ public:
         printf( "Printing row %u\n", row );
         printf( "\t%u = ", row );
 
-        Entry *rowEntry = _rows[row];
-        Entry *current;
+        Iterator rowEntry = getRow( row );
+        Iterator current;
 
         unsigned column;
         double weight;
 
-        while ( rowEntry != NULL )
+        while ( !rowEntry.atEnd() )
         {
             current = rowEntry;
-            rowEntry = rowEntry->nextInRow();
+            rowEntry.advance();
 
-            column = current->getColumn();
-            weight = current->getValue();
+            column = current.getColumn();
+            weight = current.getValue();
 
             if ( !FloatUtils::isNegative( weight ) )
                 printf( "+" );
@@ -506,6 +953,48 @@ public:
         if ( other->_size != _size )
             throw Error( Error::COPY_INCOMPATIBLE_SPARSE_MATRICES );
 
+        if ( _storageType == COMPRESSED_ROWS && other->_storageType == COMPRESSED_ROWS )
+        {
+            // The rows are shared, not copied. Whichever tableau modifies a row first copies it.
+            other->_rowSize = _rowSize;
+            other->_columnSize = _columnSize;
+            other->_columnIndexValid = false;
+
+            for ( unsigned i = 0; i < _size; ++i )
+            {
+                const CompressedRow &source( _compressedRows[i] );
+                if ( source._references == other->_compressedRows[i]._references )
+                {
+                    other->_compressedRows[i]._size = source._size;
+                    continue;
+                }
+
+                other->releaseRowEntries( other->_compressedRows[i] );
+                other->_compressedRows[i] = source;
+                if ( source._references )
+                    ++( *source._references );
+            }
+
+            return;
+        }
+
+        if ( _storageType != other->_storageType )
+        {
+            // Different engines, copy entry by entry
+            other->deleteAllEntries();
+            for ( unsigned i = 0; i < _size; ++i )
+            {
+                Iterator entry = getRow( i );
+                while ( !entry.atEnd() )
+                {
+                    other->addEntry( i, entry.getColumn(), entry.getValue() );
+                    entry.advance();
+                }
+            }
+
+            return;
+        }
+
         other->deleteAllEntries();
         other->_rowSize = _rowSize;
         other->_columnSize = _columnSize;
@@ -515,7 +1004,7 @@ public:
             Entry *entry = _rows[i];
             while ( entry )
             {
-                Entry *newEntry = new Entry;
+                Entry *newEntry = other->allocateEntry();
 
                 newEntry->setRow( entry->getRow() );
                 newEntry->setColumn( entry->getColumn() );
@@ -545,21 +1034,40 @@ public:
 
     void ensureNoZerosInRow( unsigned row ) const
     {
-        if ( _rows[row] == NULL )
-            return;
-
-        Entry *entry = _rows[row];
+        Iterator entry = getRow( row );
 
-        while ( entry != NULL )
+        while ( !entry.atEnd() )
         {
-            if ( FloatUtils::isZero( entry->getValue() ) )
+            if ( FloatUtils::isZero( entry.getValue() ) )
             {
                 printf( "Error! Found a 0 in the matrix!\n" );
                 exit( 1 );
             }
 
-            entry = entry->nextInRow();
+            entry.advance();
+        }
+    }
+
+    unsigned countDenseRows() const
+    {
+        unsigned result = 0;
+
+        if ( _storageType == COMPRESSED_ROWS )
+        {
+            for ( unsigned i = 0; i < _size; ++i )
+            {
+                if ( _compressedRows[i]._dense )
+                    ++result;
+            }
         }
+
+        return result;
+    }
+
+    // The number of rows that were copied because they were shared with another tableau
+    unsigned long long getNumRowCopies() const
+    {
+        return _numRowCopies;
     }
 
     unsigned countActiveColumns() const
@@ -577,22 +1085,817 @@ public:
 
 private:
     unsigned _size;
+    StorageType _storageType;
     Entry **_rows;
     Entry **_columns;
     Vector<unsigned> _rowSize;
     Vector<unsigned> _columnSize;
-    Map<unsigned, Entry *> _denseMap;
+
+    /*
+      A scatter array, indexed by column (when adding rows) or by row (when adding columns).
+      Only the indices listed in _touchedIndices may be non-NULL, so clearing it is
+      proportional to the number of entries that were scattered.
+    */
+    Entry **_denseMap;
+    unsigned *_touchedIndices;
+    unsigned _numTouchedIndices;
+
+    void scatter( unsigned index, Entry *entry )
+    {
+        _denseMap[index] = entry;
+        _touchedIndices[_numTouchedIndices] = index;
+        ++_numTouchedIndices;
+    }
+
+    void clearDenseMap()
+    {
+        for ( unsigned i = 0; i < _numTouchedIndices; ++i )
+            _denseMap[_touchedIndices[i]] = NULL;
+        _numTouchedIndices = 0;
+    }
+
+    /*
+      Entry allocation. Entries are handed out sequentially from the slabs, and erased
+      entries are kept on a free list (linked through their _nextInRow field) for reuse.
+    */
+    Vector<Entry *> _slabs;
+    Entry *_freeEntries;
+    unsigned _currentSlab;
+    unsigned _nextInSlab;
+
+    Entry *allocateEntry()
+    {
+        Entry *entry;
+
+        if ( _freeEntries )
+        {
+            entry = _freeEntries;
+            _freeEntries = entry->_nextInRow;
+        }
+        else
+        {
+            if ( _nextInSlab == TABLEAU_ENTRIES_PER_SLAB )
+            {
+                ++_currentSlab;
+                _nextInSlab = 0;
+            }
+
+            if ( _currentSlab == _slabs.size() )
+                _slabs.append( new Entry[TABLEAU_ENTRIES_PER_SLAB] );
+
+            entry = _slabs[_currentSlab] + _nextInSlab;
+            ++_nextInSlab;
+        }
+
+        entry->_nextInRow = NULL;
+        entry->_prevInRow = NULL;
+        entry->_nextInColumn = NULL;
+        entry->_prevInColumn = NULL;
+
+        return entry;
+    }
+
+    void releaseEntry( Entry *entry )
+    {
+        entry->_nextInRow = _freeEntries;
+        _freeEntries = entry;
+    }
 
     void dumpDenseMap()
     {
-        printf( "Dumping dense map (size = %u):\n", _denseMap.size() );
-        Map<unsigned, Entry *>::iterator it = _denseMap.begin();
-        while ( it != _denseMap.end() )
+        printf( "Dumping dense map (touched indices = %u):\n", _numTouchedIndices );
+        for ( unsigned i = 0; i < _numTouchedIndices; ++i )
         {
-            printf( "\t%u: %.5lf (address: 0x%p)\n", it->first, it->second->getValue(), it->second );
-            ++it;
+            unsigned index = _touchedIndices[i];
+            if ( _denseMap[index] )
+                printf( "\t%u: %.5lf (address: 0x%p)\n", index, _denseMap[index]->getValue(), _denseMap[index] );
         }
     }
+
+    /*
+      Compressed rows storage. Entries within a row are unordered. The column index lists,
+      for every column, the rows in which it appears and the positions of the entries within
+      these rows; it only depends on the structure of the tableau, so changing values in
+      place does not invalidate it.
+    */
+    CompressedRow *_compressedRows;
+
+    // Scatter array for the compressed rows: position + 1 of an entry, or 0 if absent
+    unsigned *_scatteredSlots;
+
+    /*
+      Scratch space for adding rows in the compressed storage. When rows are eliminated in
+      parallel, every thread has its own workspace; changes to column sizes and to the
+      statistics are buffered in it, and collected once the threads are done.
+    */
+    struct RowWorkspace
+    {
+        RowWorkspace()
+            : _scatteredSlots( NULL )
+            , _touchedIndices( NULL )
+            , _numTouchedIndices( 0 )
+            , _columnSizeChanges( NULL )
+            , _changedColumns( NULL )
+            , _numChangedColumns( 0 )
+            , _structureChanged( false )
+            , _numRowCopies( 0 )
+            , _numCalcs( 0 )
+        {
+        }
+
+        void allocateArrays( unsigned size )
+        {
+            _scatteredSlots = new unsigned[size];
+            _touchedIndices = new unsigned[size];
+            _columnSizeChanges = new int[size];
+            _changedColumns = new unsigned[size];
+
+            for ( unsigned i = 0; i < size; ++i )
+            {
+                _scatteredSlots[i] = 0;
+                _columnSizeChanges[i] = 0;
+            }
+        }
+
+        void freeArrays()
+        {
+            delete []_scatteredSlots;
+            delete []_touchedIndices;
+            delete []_columnSizeChanges;
+            delete []_changedColumns;
+        }
+
+        unsigned *_scatteredSlots;
+        unsigned *_touchedIndices;
+        unsigned _numTouchedIndices;
+
+        // When NULL, column sizes are changed directly
+        int *_columnSizeChanges;
+        unsigned *_changedColumns;
+        unsigned _numChangedColumns;
+
+        bool _structureChanged;
+        unsigned long long _numRowCopies;
+        unsigned _numCalcs;
+    };
+
+    struct EliminationTarget
+    {
+        unsigned _row;
+        double _scale;
+    };
+
+    // The workspace of the calling thread uses the tableau's own scatter arrays
+    RowWorkspace _workspace;
+    RowWorkspace *_threadWorkspaces;
+    unsigned _numThreadWorkspaces;
+    Vector<EliminationTarget> _eliminationTargets;
+
+    void allocateThreadWorkspaces( unsigned numThreads )
+    {
+        if ( _numThreadWorkspaces >= numThreads )
+            return;
+
+        for ( unsigned i = 0; i < _numThreadWorkspaces; ++i )
+            _threadWorkspaces[i].freeArrays();
+        delete []_threadWorkspaces;
+
+        _threadWorkspaces = new RowWorkspace[numThreads];
+        for ( unsigned i = 0; i < numThreads; ++i )
+            _threadWorkspaces[i].allocateArrays( _size );
+        _numThreadWorkspaces = numThreads;
+    }
+
+    static void scatterSlot( RowWorkspace &workspace, unsigned index, unsigned slot )
+    {
+        workspace._scatteredSlots[index] = slot + 1;
+        workspace._touchedIndices[workspace._numTouchedIndices] = index;
+        ++workspace._numTouchedIndices;
+    }
+
+    static void clearScatteredSlots( RowWorkspace &workspace )
+    {
+        for ( unsigned i = 0; i < workspace._numTouchedIndices; ++i )
+            workspace._scatteredSlots[workspace._touchedIndices[i]] = 0;
+        workspace._numTouchedIndices = 0;
+    }
+
+    void changeColumnSize( RowWorkspace &workspace, unsigned column, int change )
+    {
+        workspace._structureChanged = true;
+
+        if ( workspace._columnSizeChanges == NULL )
+        {
+            _columnSize[column] += change;
+            return;
+        }
+
+        if ( workspace._columnSizeChanges[column] == 0 )
+        {
+            workspace._changedColumns[workspace._numChangedColumns] = column;
+            ++workspace._numChangedColumns;
+        }
+        workspace._columnSizeChanges[column] += change;
+    }
+
+    // Apply what was buffered in a workspace, and reset it
+    void collectWorkspace( RowWorkspace &workspace, unsigned *numCalcs )
+    {
+        for ( unsigned i = 0; i < workspace._numChangedColumns; ++i )
+        {
+            unsigned column = workspace._changedColumns[i];
+            _columnSize[column] += workspace._columnSizeChanges[column];
+            workspace._columnSizeChanges[column] = 0;
+        }
+        workspace._numChangedColumns = 0;
+
+        if ( workspace._structureChanged )
+            _columnIndexValid = false;
+        workspace._structureChanged = false;
+
+        _numRowCopies += workspace._numRowCopies;
+        workspace._numRowCopies = 0;
+
+        if ( numCalcs )
+            *numCalcs += workspace._numCalcs;
+        workspace._numCalcs = 0;
+    }
+
+    mutable unsigned *_columnStart;
+    mutable ColumnEntry *_columnEntries;
+    mutable unsigned _columnEntriesCapacity;
+    mutable bool _columnIndexValid;
+
+    unsigned long long _numRowCopies;
+
+    // Rows with at least this many entries are stored densely
+    unsigned _denseRowThreshold;
+
+    static bool rowIsShared( const CompressedRow &compressedRow )
+    {
+        return compressedRow._references != NULL && *compressedRow._references > 1;
+    }
+
+    // Drop this tableau's reference to the row's entries. The size is left unchanged.
+    static void releaseRowEntries( CompressedRow &compressedRow )
+    {
+        if ( compressedRow._references != NULL )
+        {
+            --( *compressedRow._references );
+            if ( *compressedRow._references == 0 )
+            {
+                delete []compressedRow._entries;
+                delete []compressedRow._dense;
+                delete compressedRow._references;
+            }
+        }
+
+        compressedRow._entries = NULL;
+        compressedRow._dense = NULL;
+        compressedRow._references = NULL;
+        compressedRow._capacity = 0;
+    }
+
+    // Move the row into a private array of the given capacity
+    void reallocateRow( unsigned row, unsigned capacity )
+    {
+        CompressedRow &compressedRow( _compressedRows[row] );
+        unsigned size = compressedRow._size;
+
+        if ( compressedRow._dense )
+        {
+            double *dense = new double[_size];
+            memcpy( dense, compressedRow._dense, sizeof(double) * _size );
+
+            releaseRowEntries( compressedRow );
+            compressedRow._dense = dense;
+            compressedRow._references = new unsigned( 1 );
+            compressedRow._size = size;
+            return;
+        }
+
+        RowEntry *entries = new RowEntry[capacity];
+        if ( size > 0 )
+            memcpy( entries, compressedRow._entries, sizeof(RowEntry) * size );
+
+        releaseRowEntries( compressedRow );
+        compressedRow._entries = entries;
+        compressedRow._references = new unsigned( 1 );
+        compressedRow._size = size;
+        compressedRow._capacity = capacity;
+    }
+
+    // Must be called before the entries of a row are modified
+    void makeRowWritable( unsigned row )
+    {
+        if ( !rowIsShared( _compressedRows[row] ) )
+            return;
+
+        reallocateRow( row, _compressedRows[row]._capacity );
+        ++_numRowCopies;
+    }
+
+    void reserveInRow( unsigned row, unsigned capacity )
+    {
+        CompressedRow &compressedRow( _compressedRows[row] );
+        if ( compressedRow._capacity >= capacity )
+        {
+            makeRowWritable( row );
+            return;
+        }
+
+        unsigned newCapacity = compressedRow._capacity == 0 ?
+            TABLEAU_INITIAL_ROW_CAPACITY : compressedRow._capacity * 2;
+        while ( newCapacity < capacity )
+            newCapacity *= 2;
+
+        reallocateRow( row, newCapacity );
+    }
+
+    void appendToRow( unsigned row, unsigned column, double value )
+    {
+        if ( _compressedRows[row]._dense )
+        {
+            makeRowWritable( row );
+            _compressedRows[row]._dense[column] = value;
+            ++_compressedRows[row]._size;
+            return;
+        }
+
+        reserveInRow( row, _compressedRows[row]._size + 1 );
+
+        CompressedRow &compressedRow( _compressedRows[row] );
+        compressedRow._entries[compressedRow._size]._column = column;
+        compressedRow._entries[compressedRow._size]._value = value;
+        ++compressedRow._size;
+    }
+
+    // Remove an entry by moving the last entry of the row into its place
+    void removeFromRow( unsigned row, unsigned slot )
+    {
+        makeRowWritable( row );
+
+        CompressedRow &compressedRow( _compressedRows[row] );
+        --compressedRow._size;
+
+        if ( compressedRow._dense )
+        {
+            compressedRow._dense[slot] = 0.0;
+            return;
+        }
+
+        compressedRow._entries[slot] = compressedRow._entries[compressedRow._size];
+    }
+
+    void rebuildColumnIndex() const
+    {
+        unsigned total = 0;
+        for ( unsigned i = 0; i < _size; ++i )
+        {
+            _columnStart[i] = total;
+            total += _columnSize.get( i );
+        }
+        _columnStart[_size] = total;
+
+        if ( _columnEntriesCapacity < total )
+        {
+            delete []_columnEntries;
+            _columnEntriesCapacity = total * 2;
+            _columnEntries = new ColumnEntry[_columnEntriesCapacity];
+        }
+
+        // Use the scatter array to track how much of each column has been filled
+        for ( unsigned i = 0; i < _size; ++i )
+        {
+            const CompressedRow &compressedRow( _compressedRows[i] );
+            if ( compressedRow._dense )
+            {
+                for ( unsigned column = 0; column < _size; ++column )
+                {
+                    if ( compressedRow._dense[column] == 0.0 )
+                        continue;
+
+                    ColumnEntry &columnEntry( _columnEntries[_columnStart[column] + _scatteredSlots[column]] );
+                    columnEntry._row = i;
+                    columnEntry._slot = column;
+                    ++_scatteredSlots[column];
+                }
+
+                continue;
+            }
+
+            for ( unsigned j = 0; j < compressedRow._size; ++j )
+            {
+                unsigned column = compressedRow._entries[j]._column;
+                ColumnEntry &columnEntry( _columnEntries[_columnStart[column] + _scatteredSlots[column]] );
+                columnEntry._row = i;
+                columnEntry._slot = j;
+                ++_scatteredSlots[column];
+            }
+        }
+
+        for ( unsigned i = 0; i < _size; ++i )
+            _scatteredSlots[i] = 0;
+
+        _columnIndexValid = true;
+    }
+
+    // Safe to call from several threads at once, as long as the targets are different
+    void compressedAddScaledRow( RowWorkspace &workspace,
+                                 unsigned source, double scale, unsigned target,
+                                 unsigned guaranteeIndex, double guaranteeValue )
+    {
+        if ( rowIsShared( _compressedRows[target] ) )
+        {
+            reallocateRow( target, _compressedRows[target]._capacity );
+            ++workspace._numRowCopies;
+        }
+
+        CompressedRow &targetRow( _compressedRows[target] );
+        const CompressedRow &sourceRow( _compressedRows[source] );
+
+        if ( sourceRow._dense || targetRow._dense )
+        {
+            if ( !targetRow._dense )
+            {
+                convertToDense( target );
+                workspace._structureChanged = true;
+            }
+
+            denseAddScaledRow( workspace, source, scale, target, guaranteeIndex, guaranteeValue );
+
+            if ( targetRow._size < _denseRowThreshold / 2 )
+            {
+                convertToSparse( target );
+                workspace._structureChanged = true;
+            }
+            return;
+        }
+
+        for ( unsigned i = 0; i < targetRow._size; ++i )
+            scatterSlot( workspace, targetRow._entries[i]._column, i );
+
+        for ( unsigned i = 0; i < sourceRow._size; ++i )
+        {
+            unsigned column = sourceRow._entries[i]._column;
+            double newValue = sourceRow._entries[i]._value * scale;
+
+            // Statistics
+            ++workspace._numCalcs;
+
+            unsigned slot = workspace._scatteredSlots[column];
+            if ( slot != 0 )
+            {
+                RowEntry &entryInTarget( targetRow._entries[slot - 1] );
+                if ( column != guaranteeIndex )
+                    entryInTarget._value += newValue;
+                else
+                    entryInTarget._value = guaranteeValue;
+
+                // The addition is another action
+                ++workspace._numCalcs;
+            }
+            else
+            {
+                // This is a new entry for the target row
+                double value = ( column != guaranteeIndex ) ? newValue : guaranteeValue;
+                if ( !FloatUtils::isZero( value ) )
+                {
+                    appendToRow( target, column, value );
+                    changeColumnSize( workspace, column, 1 );
+                }
+            }
+        }
+
+        clearScatteredSlots( workspace );
+
+        // Drop the entries that have been zeroed out, keeping the order of the rest
+        unsigned kept = 0;
+        for ( unsigned i = 0; i < targetRow._size; ++i )
+        {
+            if ( FloatUtils::isZero( targetRow._entries[i]._value ) )
+            {
+                changeColumnSize( workspace, targetRow._entries[i]._column, -1 );
+            }
+            else
+            {
+                targetRow._entries[kept] = targetRow._entries[i];
+                ++kept;
+            }
+        }
+
+        targetRow._size = kept;
+        _rowSize[target] = kept;
+
+        if ( kept >= _denseRowThreshold )
+        {
+            convertToDense( target );
+            workspace._structureChanged = true;
+        }
+    }
+
+    // The target row is dense and not shared
+    void denseAddScaledRow( RowWorkspace &workspace,
+                            unsigned source, double scale, unsigned target,
+                            unsigned guaranteeIndex, double guaranteeValue )
+    {
+        CompressedRow &targetRow( _compressedRows[target] );
+        const CompressedRow &sourceRow( _compressedRows[source] );
+        double *values = targetRow._dense;
+
+        bool guaranteedWasNonZero = ( values[guaranteeIndex] != 0.0 );
+        bool sourceHasGuaranteed;
+
+        // Indices whose entries appeared or disappeared
+        unsigned *changed = workspace._touchedIndices;
+        unsigned numChanged = 0;
+
+        if ( sourceRow._dense )
+        {
+            sourceHasGuaranteed = ( sourceRow._dense[guaranteeIndex] != 0.0 );
+            numChanged = denseAxpy( values, sourceRow._dense, scale, _size, changed );
+            workspace._numCalcs += _size;
+        }
+        else
+        {
+            sourceHasGuaranteed = false;
+            for ( unsigned i = 0; i < sourceRow._size; ++i )
+            {
+                unsigned column = sourceRow._entries[i]._column;
+                if ( column == guaranteeIndex )
+                    sourceHasGuaranteed = true;
+
+                double oldValue = values[column];
+                double newValue = oldValue + sourceRow._entries[i]._value * scale;
+                if ( FloatUtils::isZero( newValue ) )
+                    newValue = 0.0;
+                values[column] = newValue;
+
+                if ( ( oldValue != 0.0 ) != ( newValue != 0.0 ) )
+                {
+                    changed[numChanged] = column;
+                    ++numChanged;
+                }
+            }
+
+            workspace._numCalcs += 2 * sourceRow._size;
+        }
+
+        for ( unsigned i = 0; i < numChanged; ++i )
+        {
+            unsigned column = changed[i];
+            if ( column == guaranteeIndex )
+                continue;
+
+            if ( values[column] != 0.0 )
+            {
+                changeColumnSize( workspace, column, 1 );
+                ++targetRow._size;
+            }
+            else
+            {
+                changeColumnSize( workspace, column, -1 );
+                --targetRow._size;
+            }
+        }
+
+        if ( sourceHasGuaranteed )
+            values[guaranteeIndex] = FloatUtils::isZero( guaranteeValue ) ? 0.0 : guaranteeValue;
+
+        bool guaranteedIsNonZero = ( values[guaranteeIndex] != 0.0 );
+        if ( guaranteedIsNonZero && !guaranteedWasNonZero )
+        {
+            changeColumnSize( workspace, guaranteeIndex, 1 );
+            ++targetRow._size;
+        }
+        else if ( !guaranteedIsNonZero && guaranteedWasNonZero )
+        {
+            changeColumnSize( workspace, guaranteeIndex, -1 );
+            --targetRow._size;
+        }
+
+        _rowSize[target] = targetRow._size;
+    }
+
+    // The row is not shared
+    void convertToDense( unsigned row )
+    {
+        CompressedRow &compressedRow( _compressedRows[row] );
+        unsigned size = compressedRow._size;
+
+        double *dense = new double[_size];
+        for ( unsigned i = 0; i < _size; ++i )
+            dense[i] = 0.0;
+        for ( unsigned i = 0; i < size; ++i )
+            dense[compressedRow._entries[i]._column] = compressedRow._entries[i]._value;
+
+        releaseRowEntries( compressedRow );
+        compressedRow._dense = dense;
+        compressedRow._references = new unsigned( 1 );
+        compressedRow._size = size;
+    }
+
+    // The row is not shared
+    void convertToSparse( unsigned row )
+    {
+        CompressedRow &compressedRow( _compressedRows[row] );
+        unsigned size = compressedRow._size;
+
+        unsigned capacity = TABLEAU_INITIAL_ROW_CAPACITY;
+        while ( capacity < size )
+            capacity *= 2;
+
+        RowEntry *entries = new RowEntry[capacity];
+        unsigned next = 0;
+        for ( unsigned i = 0; i < _size; ++i )
+        {
+            if ( compressedRow._dense[i] != 0.0 )
+            {
+                entries[next]._column = i;
+                entries[next]._value = compressedRow._dense[i];
+                ++next;
+            }
+        }
+
+        releaseRowEntries( compressedRow );
+        compressedRow._entries = entries;
+        compressedRow._references = new unsigned( 1 );
+        compressedRow._size = size;
+        compressedRow._capacity = capacity;
+    }
+
+    /*
+      target += scale * source, with results within epsilon of zero set to exactly zero.
+      The indices whose entries became zero or non-zero are stored in changed, and their
+      number is returned. The multiplication and the addition are rounded separately, so
+      the results are identical to those of the sparse rows.
+    */
+    static unsigned denseAxpy( double *target, const double *source, double scale,
+                               unsigned size, unsigned *changed )
+    {
+#ifdef TABLEAU_AVX2_KERNEL
+        static const bool useAvx2 = __builtin_cpu_supports( "avx2" );
+        if ( useAvx2 )
+            return denseAxpyAvx2( target, source, scale, size, changed );
+#endif
+        return denseAxpyScalar( target, source, scale, 0, size, changed, 0 );
+    }
+
+    static unsigned denseAxpyScalar( double *target, const double *source, double scale,
+                                     unsigned begin, unsigned end,
+                                     unsigned *changed, unsigned numChanged )
+    {
+        for ( unsigned i = begin; i < end; ++i )
+        {
+            double oldValue = target[i];
+            double newValue = oldValue + source[i] * scale;
+            if ( FloatUtils::isZero( newValue ) )
+                newValue = 0.0;
+            target[i] = newValue;
+
+            if ( ( oldValue != 0.0 ) != ( newValue != 0.0 ) )
+            {
+                changed[numChanged] = i;
+                ++numChanged;
+            }
+        }
+
+        return numChanged;
+    }
+
+#ifdef TABLEAU_AVX2_KERNEL
+    __attribute__(( target( "avx2" ) ))
+    static unsigned denseAxpyAvx2( double *target, const double *source, double scale,
+                                   unsigned size, unsigned *changed )
+    {
+        const __m256d scales = _mm256_set1_pd( scale );
+        const __m256d epsilon = _mm256_set1_pd( DEFAULT_EPSILON );
+        const __m256d signBit = _mm256_set1_pd( -0.0 );
+        const __m256d zero = _mm256_setzero_pd();
+
+        unsigned numChanged = 0;
+        unsigned i = 0;
+        for ( ; i + 4 <= size; i += 4 )
+        {
+            __m256d oldValues = _mm256_loadu_pd( target + i );
+            __m256d newValues = _mm256_add_pd( oldValues, _mm256_mul_pd( _mm256_loadu_pd( source + i ), scales ) );
+
+            // Zero out anything within epsilon of zero
+            __m256d isZero = _mm256_cmp_pd( _mm256_andnot_pd( signBit, newValues ), epsilon, _CMP_LE_OQ );
+            newValues = _mm256_andnot_pd( isZero, newValues );
+            _mm256_storeu_pd( target + i, newValues );
+
+            int wasNonZero = _mm256_movemask_pd( _mm256_cmp_pd( oldValues, zero, _CMP_NEQ_UQ ) );
+            int isNonZero = _mm256_movemask_pd( _mm256_cmp_pd( newValues, zero, _CMP_NEQ_UQ ) );
+            int flipped = wasNonZero ^ isNonZero;
+            while ( flipped != 0 )
+            {
+                changed[numChanged] = i + __builtin_ctz( flipped );
+                ++numChanged;
+                flipped &= flipped - 1;
+            }
+        }
+
+        return denseAxpyScalar( target, source, scale, i, size, changed, numChanged );
+    }
+#endif
+
+    void compressedAddColumnEraseSource( unsigned source, unsigned target )
+    {
+        if ( !_columnIndexValid )
+            rebuildColumnIndex();
+
+        const ColumnEntry *targetColumn = _columnEntries + _columnStart[target];
+        for ( unsigned i = 0; i < _columnSize.get( target ); ++i )
+            scatterSlot( _workspace, targetColumn[i]._row, targetColumn[i]._slot );
+
+        // Every row appears at most once in each column, so removing entries from a row
+        // does not affect the positions that are still to be visited
+        const ColumnEntry *sourceColumn = _columnEntries + _columnStart[source];
+        for ( unsigned i = 0; i < _columnSize.get( source ); ++i )
+        {
+            unsigned row = sourceColumn[i]._row;
+            unsigned sourceSlot = sourceColumn[i]._slot;
+
+            makeRowWritable( row );
+
+            if ( _compressedRows[row]._dense )
+            {
+                double *values = _compressedRows[row]._dense;
+                if ( values[target] == 0.0 )
+                {
+                    values[target] = values[sourceSlot];
+                    ++_columnSize[target];
+                }
+                else
+                {
+                    values[target] += values[sourceSlot];
+                    --_compressedRows[row]._size;
+                    --_rowSize[row];
+
+                    if ( FloatUtils::isZero( values[target] ) )
+                    {
+                        values[target] = 0.0;
+                        --_compressedRows[row]._size;
+                        --_rowSize[row];
+                        --_columnSize[target];
+                    }
+                }
+
+                values[sourceSlot] = 0.0;
+                continue;
+            }
+
+            RowEntry *entries = _compressedRows[row]._entries;
+
+            if ( _scatteredSlots[row] == 0 )
+            {
+                // There was no entry in the target column. "Steal" the entry.
+                entries[sourceSlot]._column = target;
+                ++_columnSize[target];
+                continue;
+            }
+
+            // Add from source column to target column
+            unsigned targetSlot = _scatteredSlots[row] - 1;
+            entries[targetSlot]._value += entries[sourceSlot]._value;
+
+            if ( FloatUtils::isZero( entries[targetSlot]._value ) )
+            {
+                // Remove the later entry first, so that the earlier one does not move
+                removeFromRow( row, sourceSlot > targetSlot ? sourceSlot : targetSlot );
+                removeFromRow( row, sourceSlot > targetSlot ? targetSlot : sourceSlot );
+                --_columnSize[target];
+                _rowSize[row] -= 2;
+            }
+            else
+            {
+                removeFromRow( row, sourceSlot );
+                --_rowSize[row];
+            }
+        }
+
+        clearScatteredSlots( _workspace );
+
+        _columnSize[source] = 0;
+        _columnIndexValid = false;
+    }
+
+    void compressedEraseColumn( unsigned column )
+    {
+        if ( !_columnIndexValid )
+            rebuildColumnIndex();
+
+        const ColumnEntry *columnEntries = _columnEntries + _columnStart[column];
+        for ( unsigned i = 0; i < _columnSize.get( column ); ++i )
+        {
+            removeFromRow( columnEntries[i]._row, columnEntries[i]._slot );
+            --_rowSize[columnEntries[i]._row];
+        }
+
+        _columnSize[column] = 0;
+        _columnIndexValid = false;
+    }
 };
 
 #endif // __Tableau_h__
@@ -17,14 +17,38 @@
 
 static const double UNDEFINED = 888;
 
+/*
+  The SmtCore decisions that a bound depends on, as a set of stack levels: bit i stands for
+  level i + 1, and the last bit for all levels from 64 up.
+*/
+typedef unsigned long long DecisionSet;
+static const unsigned DECISION_SET_SIZE = 64;
+
+inline DecisionSet decisionAtLevel( unsigned level )
+{
+    if ( level == 0 )
+        return 0;
+    if ( level >= DECISION_SET_SIZE )
+        return 1ULL << ( DECISION_SET_SIZE - 1 );
+    return 1ULL << ( level - 1 );
+}
+
+// Every decision up to the given level. This is always a safe choice for a bound at that level.
+inline DecisionSet decisionsUpToLevel( unsigned level )
+{
+    if ( level >= DECISION_SET_SIZE )
+        return ~0ULL;
+    return ( 1ULL << level ) - 1;
+}
+
 class VariableBound
 {
 public:
-    VariableBound() : _finite( false ), _bound( UNDEFINED ), _level( 0 )
+    VariableBound() : _finite( false ), _bound( UNDEFINED ), _level( 0 ), _decisions( 0 )
     {
     }
 
-    VariableBound( double bound ) : _finite( true ), _bound( bound ), _level( 0 )
+    VariableBound( double bound ) : _finite( true ), _bound( bound ), _level( 0 ), _decisions( 0 )
     {
     }
 
@@ -44,9 +68,17 @@ public:
         return _bound;
     }
 
+    // The bound is assumed to depend on all decisions up to its level
     void setLevel( unsigned level )
     {
         _level = level;
+        _decisions = decisionsUpToLevel( level );
+    }
+
+    void setLevel( unsigned level, DecisionSet decisions )
+    {
+        _level = level;
+        _decisions = decisions;
     }
 
     unsigned getLevel() const
@@ -54,10 +86,16 @@ public:
         return _level;
     }
 
+    DecisionSet getDecisions() const
+    {
+        return _decisions;
+    }
+
 private:
     bool _finite;
     double _bound;
     unsigned _level;
+    DecisionSet _decisions;
 };
 
 #endif // __VariableBound_h__